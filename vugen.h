@@ -29,6 +29,9 @@
 
 /* typedef unsigned long size_t; */
 
+// va_list, va_start() and va_end(), for functions taking a variable number of arguments. Ships with the LoadRunner C compiler.
+#include <stdarg.h>
+
 /***** String functions *****/
 /*! \defgroup string Standard C string functions
  * \brief Standard C functions using null terminated C strings (defined in stdio.h, cstring.h)
@@ -39,6 +42,9 @@
 int snprintf(char *buffer, size_t n, const char *format_string, ...);
 //! \brief Documented at http://www.cplusplus.com/reference/cstdio/sprintf/. \n You should prefer ::snprintf over sprintf.
 int sprintf(char *buffer, const char *format_string, ...); 
+//! \brief Documented at http://www.cplusplus.com/reference/cstdio/vsnprintf/. \n
+//! Some C libraries return -1 instead of the required size when the buffer is too small.
+int vsnprintf(char *buffer, size_t n, const char *format_string, va_list args);
 //! \brief Documented at http://www.cplusplus.com/reference/cstdio/sscanf/.
 int sscanf(const char *buffer, const char *format_string, ...);
 //! \brief Documented at http://www.cplusplus.com/reference/cstring/strchr/.
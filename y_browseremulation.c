@@ -515,6 +515,8 @@ y_browser* y_choose_browser_from_list(y_browser* browser_list_head, int browser_
     // Update: y_rand() now returns a 31 bit number, giving it an upper bound of 2147483647 (Y_RAND_MAX).
     // That should reduce the need for this code by a bit ..
     // 
+    // Update: y_rand() no longer uses rand() at all - see y_rand32().
+    // 
 
     roll = y_rand() % browser_list_chance_total;
     //lr_log_message("browser_list_chance_total = %d, RAND_MAX = %d, roll %d", browser_list_chance_total, RAND_MAX, roll);
@@ -0,0 +1,521 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_codec.c
+\brief URL, base64, hex and HTML entity encoding and decoding of parameters.
+
+These replace web_convert_param() and hand written character loops for large values such as SAML assertions and embedded documents.
+All of them are binary safe, table driven, and work out the size of the result before writing it, so each conversion
+costs exactly one allocation and one pass over the data (two for the encoders: one to measure, one to write).
+
+Each function reads a source parameter and saves the result in a result parameter. The two may be the same parameter,
+in which case the parameter is converted in place.
+
+\b Example:
+\code
+y_base64_decode("SAMLResponse", "SAMLResponse_xml");
+y_xml_get_value("SAMLResponse_xml", "/Response/Assertion/Subject/NameID", "NameID");
+y_url_encode("SAMLResponse", "SAMLResponse");  // In place, ready for a form post.
+\endcode
+*/
+#ifndef _Y_CODEC_C_
+//! \cond include_protection
+#define _Y_CODEC_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_core.c"
+#include "y_string.c"
+
+//! \cond internal_global
+//! INTERNAL: Digits used by the encoders.
+const char _y_hex_digits[] = "0123456789ABCDEF";
+//! INTERNAL: The base64 alphabet.
+const char _y_base64_alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+//! INTERNAL: Reverse lookup tables for the decoders. 0-63 (base64) or 0-15 (hex) for valid characters, -1 for anything else. \sa y_codec_init_tables()
+signed char _y_base64_values[256];
+signed char _y_hex_values[256];
+//! INTERNAL: Characters that y_url_encode() leaves alone.
+char _y_url_unreserved[256];
+//! INTERNAL: Whether the tables above have been filled in.
+int _y_codec_tables_initialized = 0;
+//! \endcond
+
+
+//! \cond internal_functions
+void y_codec_init_tables()
+{
+    int i;
+
+    if( _y_codec_tables_initialized )
+        return;
+    for( i = 0; i < 256; i++ )
+    {
+        _y_base64_values[i] = -1;
+        _y_hex_values[i] = -1;
+        _y_url_unreserved[i] = (i >= 'a' && i <= 'z') || (i >= 'A' && i <= 'Z') || (i >= '0' && i <= '9')
+                             || i == '-' || i == '_' || i == '.' || i == '*';
+    }
+    for( i = 0; i < 64; i++ )
+        _y_base64_values[(unsigned char)_y_base64_alphabet[i]] = i;
+    // Also accept the URL safe alphabet (RFC 4648 section 5).
+    _y_base64_values['-'] = 62;
+    _y_base64_values['_'] = 63;
+    for( i = 0; i < 10; i++ )
+        _y_hex_values['0' + i] = i;
+    for( i = 0; i < 6; i++ )
+    {
+        _y_hex_values['a' + i] = 10 + i;
+        _y_hex_values['A' + i] = 10 + i;
+    }
+    _y_codec_tables_initialized = 1;
+}
+
+// Fetch the source parameter of a conversion. Aborts if it doesn't exist.
+y_strview y_codec_get_source(const char* function_name, const char* source_param)
+{
+    y_strview source = y_get_parameter_view(source_param);
+
+    y_codec_init_tables();
+    if( source.ptr == NULL )
+    {
+        lr_error_message("%s(): Error: Parameter %s does not exist!", function_name, source_param);
+        lr_abort();
+    }
+    return source;
+}
+
+// Save the result of a conversion, free the buffer it was built in and release the arena mark of the caller (which holds the source). Returns the length.
+int y_codec_save_result(char* result, size_t len, const char* result_param, y_arena_mark mark)
+{
+    lr_save_var(len ? result : "", len, 0, result_param);
+    free(result);
+    y_arena_release(mark);
+    return len;
+}
+
+// Write a unicode code point as UTF-8. Returns the position after it.
+char* y_utf8_encode(char* out, unsigned int c)
+{
+    if( c < 0x80 )
+        *out++ = c;
+    else if( c < 0x800 )
+    {
+        *out++ = 0xC0 | (c >> 6);
+        *out++ = 0x80 | (c & 0x3F);
+    }
+    else if( c < 0x10000 )
+    {
+        *out++ = 0xE0 | (c >> 12);
+        *out++ = 0x80 | ((c >> 6) & 0x3F);
+        *out++ = 0x80 | (c & 0x3F);
+    }
+    else
+    {
+        *out++ = 0xF0 | (c >> 18);
+        *out++ = 0x80 | ((c >> 12) & 0x3F);
+        *out++ = 0x80 | ((c >> 6) & 0x3F);
+        *out++ = 0x80 | (c & 0x3F);
+    }
+    return out;
+}
+
+// Decode %XX escapes and '+' into dest, which must have room for src.len bytes. Malformed escapes are copied as they are.
+size_t y_url_decode_buffer(y_strview src, char* dest)
+{
+    const unsigned char* p = (const unsigned char*) src.ptr;
+    const unsigned char* end = p + src.len;
+    char* out = dest;
+
+    while( p < end )
+    {
+        if( *p == '%' && end - p >= 3 && _y_hex_values[p[1]] >= 0 && _y_hex_values[p[2]] >= 0 )
+        {
+            *out++ = (_y_hex_values[p[1]] << 4) | _y_hex_values[p[2]];
+            p += 3;
+        }
+        else if( *p == '+' )
+        {
+            *out++ = ' ';
+            p++;
+        }
+        else
+            *out++ = *p++;
+    }
+    return out - dest;
+}
+
+// Decode base64 into dest, which must have room for src.len / 4 * 3 + 3 bytes. Returns the length, or -1 if the input is not base64.
+int y_base64_decode_buffer(y_strview src, char* dest)
+{
+    const unsigned char* p = (const unsigned char*) src.ptr;
+    const unsigned char* end = p + src.len;
+    unsigned char* out = (unsigned char*) dest;
+    unsigned int group = 0;
+    int n = 0;
+    int padding = 0;
+
+    for( ; p < end; p++ )
+    {
+        int value = _y_base64_values[*p];
+        if( value >= 0 && !padding )
+        {
+            group = (group << 6) | value;
+            if( ++n == 4 )
+            {
+                *out++ = group >> 16;
+                *out++ = group >> 8;
+                *out++ = group;
+                group = 0;
+                n = 0;
+            }
+        }
+        else if( *p == '=' && (n >= 2 || padding) )
+            padding++;
+        else if( *p != '\r' && *p != '\n' && *p != ' ' && *p != '\t' )
+            return -1;
+    }
+
+    // A trailing partial group, with or without padding.
+    if( n == 1 || padding > 2 )
+        return -1;
+    if( n == 2 )
+        *out++ = group >> 4;
+    else if( n == 3 )
+    {
+        *out++ = group >> 10;
+        *out++ = group >> 2;
+    }
+    return out - (unsigned char*) dest;
+}
+
+// Decode HTML entities into dest, which must have room for src.len bytes. Unknown entities are copied as they are.
+size_t y_html_unescape_buffer(y_strview src, char* dest)
+{
+    // The most common named entities. Anything else can be written as a numeric reference anyway.
+    static const char* names[] = { "amp", "lt", "gt", "quot", "apos", "nbsp", "copy", "reg", "trade", "euro", "pound", "yen", "cent", "sect",
+                                   "deg", "plusmn", "times", "divide", "middot", "para", "laquo", "raquo", "lsquo", "rsquo", "ldquo", "rdquo",
+                                   "ndash", "mdash", "hellip", "bull", "iexcl", "iquest", "szlig", "auml", "ouml", "uuml", "Auml", "Ouml", "Uuml",
+                                   "eacute", "egrave", "ecirc", "euml", "aacute", "agrave", "ccedil", "Eacute", NULL };
+    static const unsigned int code_points[] = { '&', '<', '>', '"', '\'', 0xA0, 0xA9, 0xAE, 0x2122, 0x20AC, 0xA3, 0xA5, 0xA2, 0xA7,
+                                   0xB0, 0xB1, 0xD7, 0xF7, 0xB7, 0xB6, 0xAB, 0xBB, 0x2018, 0x2019, 0x201C, 0x201D,
+                                   0x2013, 0x2014, 0x2026, 0x2022, 0xA1, 0xBF, 0xDF, 0xE4, 0xF6, 0xFC, 0xC4, 0xD6, 0xDC,
+                                   0xE9, 0xE8, 0xEA, 0xEB, 0xE1, 0xE0, 0xE7, 0xC9 };
+    const char* p = src.ptr;
+    const char* end = src.ptr + src.len;
+    char* out = dest;
+
+    while( p < end )
+    {
+        const char* amp = (const char*) memchr(p, '&', end - p);
+        const char* semicolon;
+        unsigned int c = 0;
+        size_t name_len;
+
+        if( amp == NULL )
+            amp = end;
+        memmove(out, p, amp - p);
+        out += amp - p;
+        if( (p = amp) == end )
+            break;
+
+        semicolon = (const char*) memchr(p, ';', end - p < 12 ? end - p : 12);
+        if( semicolon == NULL )
+        {
+            *out++ = *p++;
+            continue;
+        }
+        name_len = semicolon - p - 1;
+        if( name_len > 1 && p[1] == '#' )
+        {
+            char number[12];
+            char* number_end;
+            memcpy(number, p + 2, name_len - 1);
+            number[name_len - 1] = '\0';
+            if( number[0] == 'x' || number[0] == 'X' )
+                c = strtoul(number + 1, &number_end, 16);
+            else
+                c = strtoul(number, &number_end, 10);
+            if( *number_end != '\0' )
+                c = 0;
+        }
+        else
+        {
+            int i;
+            for( i = 0; names[i] != NULL; i++ )
+            {
+                if( strlen(names[i]) == name_len && strncmp(p + 1, names[i], name_len) == 0 )
+                {
+                    c = code_points[i];
+                    break;
+                }
+            }
+        }
+        if( c == 0 || c > 0x10FFFF )
+        {
+            // Unknown entity. Leave it as it is.
+            *out++ = *p++;
+            continue;
+        }
+        out = y_utf8_encode(out, c);
+        p = semicolon + 1;
+    }
+    return out - dest;
+}
+//! \endcond
+
+
+/*!
+\brief URL encode a parameter, the way browsers encode form fields.
+
+Letters, digits and the characters "-_.*" are left alone, spaces become '+', and everything else is written as %XX.
+This is application/x-www-form-urlencoded encoding, suitable for form posts as well as query strings.
+
+\param [in] source_param The parameter to encode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter.
+\returns The length of the result. If the source parameter does not exist this logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("a b&c=d", "Value");
+y_url_encode("Value", "Value");   // {Value} is now "a+b%26c%3Dd"
+\endcode
+\sa y_url_decode(), web_convert_param()
+*/
+int y_url_encode(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_url_encode", source_param);
+    const unsigned char* p = (const unsigned char*) source.ptr;
+    const unsigned char* end = p + source.len;
+    size_t size = source.len;
+    char* result;
+    char* out;
+
+    // Measure first: each byte that needs escaping grows by 2 bytes.
+    for( ; p < end; p++ )
+    {
+        if( !_y_url_unreserved[*p] && *p != ' ' )
+            size += 2;
+    }
+
+    out = result = y_mem_alloc(size + 1);
+    for( p = (const unsigned char*) source.ptr; p < end; p++ )
+    {
+        if( _y_url_unreserved[*p] )
+            *out++ = *p;
+        else if( *p == ' ' )
+            *out++ = '+';
+        else
+        {
+            *out++ = '%';
+            *out++ = _y_hex_digits[*p >> 4];
+            *out++ = _y_hex_digits[*p & 0x0F];
+        }
+    }
+    return y_codec_save_result(result, size, result_param, mark);
+}
+
+/*!
+\brief Decode a URL encoded parameter.
+
+%XX escapes are decoded, and '+' becomes a space. Malformed escapes are left as they are.
+
+\param [in] source_param The parameter to decode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter.
+\returns The length of the result. If the source parameter does not exist this logs an error and calls lr_abort().
+\sa y_url_encode()
+*/
+int y_url_decode(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_url_decode", source_param);
+    char* result = y_mem_alloc(source.len + 1);
+    return y_codec_save_result(result, y_url_decode_buffer(source, result), result_param, mark);
+}
+
+/*!
+\brief Base64 encode a parameter.
+
+Uses the standard alphabet, with padding, and without line breaks.
+
+\param [in] source_param The parameter to encode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter.
+\returns The length of the result. If the source parameter does not exist this logs an error and calls lr_abort().
+\sa y_base64_decode()
+*/
+int y_base64_encode(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_base64_encode", source_param);
+    const unsigned char* p = (const unsigned char*) source.ptr;
+    const unsigned char* end = p + source.len;
+    size_t size = (source.len + 2) / 3 * 4;
+    char* result = y_mem_alloc(size + 1);
+    char* out = result;
+
+    // Whole groups of 3 bytes first, then the remainder.
+    for( ; end - p >= 3; p += 3 )
+    {
+        unsigned int group = (p[0] << 16) | (p[1] << 8) | p[2];
+        out[0] = _y_base64_alphabet[group >> 18];
+        out[1] = _y_base64_alphabet[(group >> 12) & 0x3F];
+        out[2] = _y_base64_alphabet[(group >> 6) & 0x3F];
+        out[3] = _y_base64_alphabet[group & 0x3F];
+        out += 4;
+    }
+    if( p < end )
+    {
+        unsigned int group = (p[0] << 16) | (end - p == 2 ? p[1] << 8 : 0);
+        out[0] = _y_base64_alphabet[group >> 18];
+        out[1] = _y_base64_alphabet[(group >> 12) & 0x3F];
+        out[2] = end - p == 2 ? _y_base64_alphabet[(group >> 6) & 0x3F] : '=';
+        out[3] = '=';
+    }
+    return y_codec_save_result(result, size, result_param, mark);
+}
+
+/*!
+\brief Decode a base64 encoded parameter.
+
+Both the standard and the URL safe alphabet are accepted. Padding is optional, and line breaks and other whitespace are ignored.
+
+\param [in] source_param The parameter to decode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter. The result may contain null bytes.
+\returns The length of the result, or -1 if the source is not valid base64. In that case the result parameter is not touched.
+If the source parameter does not exist this logs an error and calls lr_abort().
+\sa y_base64_encode()
+*/
+int y_base64_decode(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_base64_decode", source_param);
+    char* result = y_mem_alloc(source.len / 4 * 3 + 4);
+    int len = y_base64_decode_buffer(source, result);
+
+    if( len < 0 )
+    {
+        lr_error_message("y_base64_decode(): Parameter %s does not contain valid base64.", source_param);
+        free(result);
+        y_arena_release(mark);
+        return -1;
+    }
+    return y_codec_save_result(result, len, result_param, mark);
+}
+
+/*!
+\brief Hex encode a parameter.
+
+Each byte becomes two uppercase hex digits.
+
+\param [in] source_param The parameter to encode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter.
+\returns The length of the result. If the source parameter does not exist this logs an error and calls lr_abort().
+\sa y_hex_decode()
+*/
+int y_hex_encode(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_hex_encode", source_param);
+    const unsigned char* p = (const unsigned char*) source.ptr;
+    const unsigned char* end = p + source.len;
+    char* result = y_mem_alloc(source.len * 2 + 1);
+    char* out = result;
+
+    for( ; p < end; p++ )
+    {
+        *out++ = _y_hex_digits[*p >> 4];
+        *out++ = _y_hex_digits[*p & 0x0F];
+    }
+    return y_codec_save_result(result, source.len * 2, result_param, mark);
+}
+
+/*!
+\brief Decode a hex encoded parameter.
+
+Upper and lower case digits are both accepted.
+
+\param [in] source_param The parameter to decode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter. The result may contain null bytes.
+\returns The length of the result, or -1 if the source is not an even number of hex digits. In that case the result parameter is not touched.
+If the source parameter does not exist this logs an error and calls lr_abort().
+\sa y_hex_encode()
+*/
+int y_hex_decode(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_hex_decode", source_param);
+    const unsigned char* p = (const unsigned char*) source.ptr;
+    const unsigned char* end = p + source.len;
+    char* result;
+    char* out;
+
+    if( source.len % 2 != 0 )
+    {
+        lr_error_message("y_hex_decode(): Parameter %s contains an odd number of characters.", source_param);
+        y_arena_release(mark);
+        return -1;
+    }
+    out = result = y_mem_alloc(source.len / 2 + 1);
+    for( ; p < end; p += 2 )
+    {
+        if( _y_hex_values[p[0]] < 0 || _y_hex_values[p[1]] < 0 )
+        {
+            lr_error_message("y_hex_decode(): Parameter %s contains a character that is not a hex digit at offset %d.", source_param, (const char*) p - source.ptr);
+            free(result);
+            y_arena_release(mark);
+            return -1;
+        }
+        *out++ = (_y_hex_values[p[0]] << 4) | _y_hex_values[p[1]];
+    }
+    return y_codec_save_result(result, source.len / 2, result_param, mark);
+}
+
+/*!
+\brief Decode the HTML entities in a parameter.
+
+Numeric references (&amp;#233; and &amp;#xE9;) and the common named entities are decoded to UTF-8. Unknown entities are left as they are.
+
+\param [in] source_param The parameter to decode.
+\param [in] result_param The parameter to save the result in. May be the same as the source parameter.
+\returns The length of the result. If the source parameter does not exist this logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("Fish &amp; chips &euro;&#32;5", "Menu");
+y_html_unescape("Menu", "Menu");   // {Menu} is now "Fish & chips € 5"
+\endcode
+\sa y_form_extract()
+*/
+int y_html_unescape(const char* source_param, const char* result_param)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_codec_get_source("y_html_unescape", source_param);
+    char* result = y_mem_alloc(source.len + 1);
+    return y_codec_save_result(result, y_html_unescape_buffer(source, result), result_param, mark);
+}
+
+#endif // _Y_CODEC_C_
@@ -66,19 +66,78 @@ We define it here mostly for documentation, as we do not have access to the head
 \def Y_RAND_MAX 
 \brief Alternate RAND_MAX constant for use with y_rand.
 
-y_rand() provides for a far bigger ceiling to the random number generator: 31 bits on Windows and 30 bits otherwise, instead of 15.
+y_rand() provides for a far bigger ceiling to the random number generator: 31 bits, instead of 15.
 \author Floris Kraak
 */
-#ifdef WINNT
-    #define Y_RAND_MAX 2147483647
-#else
-    #define Y_RAND_MAX 1073741823
-#endif
+#define Y_RAND_MAX 2147483647
+
+//! \cond internal_global
+//! INTERNAL: State of the per-vuser xoshiro128** random number generator. \sa y_srand(), y_rand32()
+unsigned int _y_rand_state[4] = { 0, 0, 0, 0 };
+//! INTERNAL: Non-zero once the random number generator has been seeded. \sa y_setup()
+int _y_rand_seeded = 0;
+//! \endcond
+
+void y_setup();
+
+/*! \brief Scramble a 32 bit number (murmur3 finalizer).
+
+Used to turn seeds that look alike (vuser ids 1, 2, 3 ..) into generator states that do not.
+\param [in] x The number to scramble.
+\returns The scrambled number.
+\sa y_srand()
+*/
+unsigned int y_rand_mix32(unsigned int x)
+{
+    x ^= x >> 16;
+    x *= 0x85EBCA6B;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35;
+    x ^= x >> 16;
+    return x;
+}
+
+/*! \brief Seed the ylib random number generator.
+
+The seed is combined with the virtual user id and scenario id, so every vuser gets it's own independent stream of random numbers even when all of them use the same seed.
+Normally there is no need to call this; y_setup() seeds the generator from the "-ylib_seed" attribute (if set) or the current time.
+
+\param [in] seed The seed to use. The same seed on the same vuser will produce the same sequence of numbers.
+
+\b Example:
+\code
+y_srand(12345);                            // Reproducible random choices for this vuser.
+lr_log_message("Roll: %d", y_rand() % 6);
+\endcode
+\sa y_rand(), y_drand(), y_rand64(), y_setup()
+*/
+void y_srand(unsigned int seed)
+{
+    int i;
+    unsigned int h;
+
+    y_setup();
+    h = y_rand_mix32(seed);
+    h = y_rand_mix32(h ^ (unsigned int)y_virtual_user_id);
+    h = y_rand_mix32(h ^ (unsigned int)y_scid);
+
+    // Splitmix style expansion of the combined seed into the four state words.
+    for(i=0; i < 4; i++)
+    {
+        h += 0x9E3779B9;
+        _y_rand_state[i] = y_rand_mix32(h);
+    }
+    // The all zero state is the only one xoshiro cannot escape from.
+    if( !(_y_rand_state[0] | _y_rand_state[1] | _y_rand_state[2] | _y_rand_state[3]) )
+        _y_rand_state[0] = 1;
+    _y_rand_seeded = 1;
+}
 
 /*!   
 \brief Ylib setup - determines and stores the identity of the virtual user.
 
 This runs lr_whoami and sets y_virtual_user_id and y_virtual_user_group as global variables.
+It also seeds the random number generator behind y_rand(), using the "-ylib_seed" attribute if it is set.
 Called y_rand() (for it's seed), y_is_vugen_run() and others dynamically.
 
 \return void
@@ -103,8 +162,14 @@ void y_setup()
     lr_whoami(&y_virtual_user_id, &y_virtual_user_group, &y_scid);
 	y_is_vugen_run_bool = y_virtual_user_id == -1;
 	
-	// srand() no longer required on Windows but rand() may still be used in user code so we leave it in.
+	// srand() no longer required for y_rand() but rand() may still be used in user code so we leave it in.
 	srand(time(NULL) + y_virtual_user_id + ((int)y_virtual_user_group) & 1023);
+
+    // Seed y_rand() and friends. Use "-ylib_seed <number>" in the runtime settings attributes for reproducible runs.
+    {
+        char* seed = lr_get_attrib_string("ylib_seed");
+        y_srand( (seed != NULL && *seed) ? strtoul(seed, NULL, 10) : (unsigned int)time(NULL) );
+    }
 }
 
 //! \brief Hook to ensure that ::y_setup() is called at start-up. This allows many performance improvements in the library.
@@ -146,8 +211,37 @@ Action()
 */
 #define y_is_vugen_run() y_is_vugen_run_bool
 
-/*! \brief Generate a random (integer) number between 0 and Y_RAND_MAX (30 bit maxint).
-\return Random number (integer) between 0 and Y_RAND_MAX: 30-bit maxint - slightly over 1 billion.
+/*! \brief Generate a random 32 bit number.
+
+This is the core of the ylib random number generator: xoshiro128** with a separate state for each virtual user.
+It does not share any state with rand(), so it is fast and the streams of different vusers do not influence each other.
+
+\return Random number between 0 and 4294967295 (inclusive).
+\sa y_rand(), y_drand(), y_rand64(), y_srand()
+*/
+unsigned int y_rand32(void)
+{
+    unsigned int *s = _y_rand_state;
+    unsigned int result, t;
+
+    if( !_y_rand_seeded )
+        y_setup();
+
+    result = s[1] * 5;
+    result = ((result << 7) | (result >> 25)) * 9;
+    t = s[1] << 9;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 11) | (s[3] >> 21);
+    return result;
+}
+
+/*! \brief Generate a random (integer) number between 0 and Y_RAND_MAX (31 bit maxint).
+\return Random number (integer) between 0 and Y_RAND_MAX: 31-bit maxint - slightly over 2 billion.
 \note Superseded by ::y_drand
 
 \b Example:
@@ -160,20 +254,9 @@ random_number=y_rand();
 */
 long y_rand(void)
 {
-   // Because rand() does not return numbers above 32767 and we want to get at least 30 of the 31 bits
-   // of randomness that a long affords us we are going to roll multiple numbers and basically 
-   // concatenate them together using bit shifts.
-   // 
-   // (If we were to go to 32 bits this function would return negative numbers, which would be undesirable
-   // because it will break people's expectations of what rand() does.)
-#ifdef WINNT
-    // On Windows we can use rand_s which returns a truly 32 bit random number. But we strip off the sign bit. 
-    unsigned int randomValue;
-    rand_s(&randomValue);
-    return randomValue & Y_RAND_MAX;
-#else
-    return rand() << 15 | rand();
-#endif
+    // Strip off the sign bit. If we were to go to 32 bits this function would return negative numbers, 
+    // which would be undesirable because it will break people's expectations of what rand() does.
+    return y_rand32() >> 1;
 }
 
 /*! \brief Generate a random number between 0 <= y_drand() < 1. This supersedes y_rand(). \n
@@ -193,16 +276,39 @@ int value = min + y_drand() * (max - min + 1); // for min <= value <= max
 */
 double y_drand(void)
 {
-#ifdef WINNT
-    // On Windows we can use rand_s which returns a truly 32 bit random number. 
-    unsigned int randomValue;
-    rand_s(&randomValue);
-    return (double)randomValue / 4294967296.;
-#else
-    return (rand() << 15 | rand())/1073741824.;
-#endif
+    return y_rand32() / 4294967296.;
 }
 
+/*! \brief 64 bit unsigned number, as two 32 bit halves.
+
+Loadrunner lacks proper 64 bit integer support, so this uses the same trick as y_get_disk_space().
+\sa y_rand64()
+*/
+typedef struct y_struct_uint64
+{
+    //! The least significant 32 bits.
+    unsigned int low;
+    //! The most significant 32 bits.
+    unsigned int high;
+} y_uint64;
+
+/*! \brief Generate a random 64 bit number.
+\return A y_uint64 struct filled with 64 random bits.
+
+\b Example:
+\code
+y_uint64 id = y_rand64();
+lr_param_sprintf("request_id", "%08x%08x", id.high, id.low);
+\endcode
+\sa y_rand32(), y_drand()
+*/
+y_uint64 y_rand64(void)
+{
+    y_uint64 result;
+    result.high = y_rand32();
+    result.low = y_rand32();
+    return result;
+}
 
 /*!
 \brief Ylib wrapper for ::malloc()
@@ -281,6 +387,421 @@ char* y_strdup(char* source)
     return result;
 }
 
+/*! \brief Default size of a block of arena memory. \sa y_arena_alloc() */
+#define Y_ARENA_BLOCK_SIZE 65536
+
+/*! \brief Internal arena block header. The block's memory follows directly after it.
+\sa y_arena_alloc()
+*/
+struct y_struct_arena_block
+{
+    //! The next block in the chain. Blocks after the current one are free.
+    struct y_struct_arena_block* next;
+    //! Usable size of this block, in bytes.
+    size_t size;
+    //! Number of bytes handed out from this block.
+    size_t used;
+};
+//! \brief Internal arena block header. \sa y_arena_alloc()
+typedef struct y_struct_arena_block y_arena_block;
+
+/*! \brief Internal record of a buffer owned by the arena. The record itself lives in the arena.
+\sa y_arena_adopt_eval_buffer()
+*/
+struct y_struct_arena_buffer
+{
+    //! The buffer adopted before this one.
+    struct y_struct_arena_buffer* next;
+    //! The buffer, allocated by lr_eval_string_ext().
+    char* buffer;
+};
+//! \brief Internal record of a buffer owned by the arena. \sa y_arena_adopt_eval_buffer()
+typedef struct y_struct_arena_buffer y_arena_buffer;
+
+/*! \brief A saved arena position, as returned by y_arena_get_mark().
+\sa y_arena_get_mark(), y_arena_release()
+*/
+typedef struct y_struct_arena_mark
+{
+    //! The block that was current when the mark was taken. NULL if nothing was allocated.
+    y_arena_block* block;
+    //! The amount of memory in use in that block.
+    size_t used;
+    //! The most recently adopted buffer when the mark was taken.
+    y_arena_buffer* buffers;
+    //! The number of arena resets before the mark was taken. A mark from before the last reset is stale. \sa y_arena_reset()
+    unsigned int generation;
+} y_arena_mark;
+
+//! \cond internal_global
+//! INTERNAL: First block of the ylib arena. \sa y_arena_alloc()
+y_arena_block* _y_arena_first = NULL;
+//! INTERNAL: Block the ylib arena currently allocates from. \sa y_arena_alloc()
+y_arena_block* _y_arena_current = NULL;
+//! INTERNAL: Buffers owned by the arena, most recently adopted first. \sa y_arena_adopt_eval_buffer()
+y_arena_buffer* _y_arena_buffers = NULL;
+//! INTERNAL: The number of times the arena was reset. \sa y_arena_reset()
+unsigned int _y_arena_generation = 0;
+//! \endcond
+
+/*!
+\brief Allocate a block of temporary memory from the ylib arena.
+
+The arena is a bump pointer allocator for short-lived temporaries: Allocating is just moving a pointer, and there is no need to free() the result.
+Memory is handed back in bulk with y_arena_release() or y_arena_reset(). The underlying blocks are kept around for reuse, so after the first few
+calls no heap allocations take place at all.
+
+Ylib itself always releases what it allocates before returning. Script code can use the arena for iteration scoped temporaries;
+y_pace() and y_errorcheck() reset it at the start of each iteration. Scripts that use neither should call y_arena_reset() at the start of the iteration themselves.
+
+\param [in] size Number of bytes required.
+\returns A pointer to (uninitialized) memory, aligned to 8 bytes. Aborts the vuser if no memory is available.
+\warning Never call free() on arena memory.
+
+\b Example:
+\code
+y_arena_mark mark = y_arena_get_mark();
+char *tmp = y_arena_alloc(100);
+snprintf(tmp, 100, "%s_%d", "TAG", 4);
+lr_save_string("value", tmp);
+y_arena_release(mark);   // tmp is gone now.
+\endcode
+\sa y_arena_get_mark(), y_arena_release(), y_arena_reset(), y_arena_strdup()
+*/
+char* y_arena_alloc(size_t size)
+{
+    y_arena_block* block = _y_arena_current;
+    char* result;
+
+    size = (size + 7) & ~7;
+    if( block == NULL || block->size - block->used < size )
+    {
+        // The blocks after the current one are all free.
+        y_arena_block* next = block ? block->next : _y_arena_first;
+
+        if( next != NULL && next->size >= size )
+        {
+            next->used = 0;
+            block = next;
+        }
+        else
+        {
+            size_t block_size = size > Y_ARENA_BLOCK_SIZE ? size : Y_ARENA_BLOCK_SIZE;
+            y_arena_block* new_block = (y_arena_block*) y_mem_alloc( sizeof(y_arena_block) + block_size );
+            new_block->size = block_size;
+            new_block->used = 0;
+            new_block->next = next;
+            if( block == NULL )
+                _y_arena_first = new_block;
+            else
+                block->next = new_block;
+            block = new_block;
+        }
+        _y_arena_current = block;
+    }
+
+    result = (char*)(block + 1) + block->used;
+    block->used += size;
+    return result;
+}
+
+/*!
+\brief Copy a string into arena memory.
+\param [in] source The string to copy.
+\returns A copy of the string, allocated with y_arena_alloc().
+\sa y_arena_alloc(), y_strdup()
+*/
+char* y_arena_strdup(const char* source)
+{
+    size_t size = strlen(source) +1;
+    char* result = y_arena_alloc(size);
+    memcpy(result, source, size);
+    return result;
+}
+
+/*!
+\brief Remember the current arena position, so that everything allocated after it can be released in one go.
+\returns The current position of the arena.
+\sa y_arena_release(), y_arena_alloc()
+*/
+y_arena_mark y_arena_get_mark()
+{
+    y_arena_mark mark;
+    mark.block = _y_arena_current;
+    mark.used = _y_arena_current ? _y_arena_current->used : 0;
+    mark.buffers = _y_arena_buffers;
+    mark.generation = _y_arena_generation;
+    return mark;
+}
+
+//! \cond internal_functions
+// Free the buffers adopted after the given one, most recent first.
+void y_arena_free_buffers(y_arena_buffer* until)
+{
+    while( _y_arena_buffers != NULL && _y_arena_buffers != until )
+    {
+        y_arena_buffer* record = _y_arena_buffers;
+        _y_arena_buffers = record->next;
+        lr_eval_string_ext_free(&record->buffer);
+    }
+}
+//! \endcond
+
+/*!
+\brief Release all arena memory allocated after the given mark was taken.
+
+Buffers handed to y_arena_adopt_eval_buffer() after the mark was taken are freed as well.
+A mark taken before the last y_arena_reset() may point into a block that no longer exists. Such a mark is ignored, with an error.
+\param [in] mark A position returned by y_arena_get_mark().
+\warning Pointers to memory allocated after the mark are invalid after this call.
+\sa y_arena_get_mark(), y_arena_alloc()
+*/
+void y_arena_release(y_arena_mark mark)
+{
+    if( mark.generation != _y_arena_generation )
+    {
+        lr_error_message("y_arena_release(): Ignoring a mark that was taken before the arena was reset.");
+        return;
+    }
+    y_arena_free_buffers(mark.buffers);
+    _y_arena_current = mark.block;
+    if( mark.block != NULL )
+        mark.block->used = mark.used;
+}
+
+/*!
+\brief Release all memory in the arena.
+
+Oversized blocks (created for requests bigger than ::Y_ARENA_BLOCK_SIZE) are handed back to the heap, so a single large temporary does not stick around for the rest of the test.
+Buffers owned by the arena (see y_arena_adopt_eval_buffer()) are freed.
+Called automatically at the start of each iteration by y_pace() and y_errorcheck().
+Marks taken before the reset are stale afterwards: y_arena_release() ignores them.
+
+\sa y_arena_alloc(), y_arena_release()
+*/
+void y_arena_reset()
+{
+    y_arena_block** link = &_y_arena_first;
+
+    y_arena_free_buffers(NULL);
+    while( *link != NULL )
+    {
+        y_arena_block* block = *link;
+        if( block->size > Y_ARENA_BLOCK_SIZE )
+        {
+            *link = block->next;
+            free(block);
+        }
+        else
+        {
+            block->used = 0;
+            link = &block->next;
+        }
+    }
+    _y_arena_current = NULL;
+    _y_arena_generation++;
+}
+
+/*!
+\brief Hand a buffer allocated by lr_eval_string_ext() over to the arena.
+
+The buffer is freed with lr_eval_string_ext_free() when the arena is released past the current position, or reset.
+This ties the lifetime of large parameter contents to the arena mark of the caller, without copying them into the arena.
+\param [in] buffer The buffer, as returned by lr_eval_string_ext().
+\returns The buffer.
+\sa y_arena_release(), y_get_parameter_view()
+*/
+char* y_arena_adopt_eval_buffer(char* buffer)
+{
+    y_arena_buffer* record = (y_arena_buffer*) y_arena_alloc(sizeof(y_arena_buffer));
+
+    record->buffer = buffer;
+    record->next = _y_arena_buffers;
+    _y_arena_buffers = record;
+    return buffer;
+}
+
+/*!
+\brief Obtain the string required to fetch the contents of a parameter through lr_eval_string(), in arena memory.
+\param [in] param_name The parameter name to construct the eval text for.
+\returns a char* allocated with y_arena_alloc()
+\sa y_get_parameter_eval_string(), y_arena_alloc()
+*/
+char* y_arena_get_parameter_eval_string(const char *param_name)
+{
+    size_t len = strlen(param_name);
+    char *result = y_arena_alloc( len +3 ); // parameter name + "{}" + '\0' (end of string)
+
+    result[0] = '{';
+    memcpy(result +1, param_name, len);
+    result[len +1] = '}';
+    result[len +2] = '\0';
+    return result;
+}
+
+/*! \brief Number of hash buckets in the interned parameter name table. Must be a power of two. \sa y_intern_parameter_name() */
+#define Y_PARAM_NAME_BUCKETS 1024
+/*! \brief Maximum number of parameter names that will be interned.
+Beyond this y_get_interned_eval_string() builds the eval string in the arena instead, so scripts that generate
+endless unique parameter names cannot grow the table without bounds.
+\sa y_intern_parameter_name()
+*/
+#define Y_PARAM_NAME_LIMIT 4096
+
+/*! \brief An interned parameter name, which doubles as a parameter handle.
+
+Entries are created by y_intern_parameter_name() and y_param_resolve(), and are never freed.
+The eval string ("{name}") and the name itself are stored directly after the structure, in the same allocation.
+\sa y_intern_parameter_name(), y_param_resolve()
+*/
+struct y_struct_param
+{
+    //! The next entry in the same hash bucket.
+    struct y_struct_param* next;
+    //! Hash of the parameter name. \sa y_hash_string()
+    unsigned int hash;
+    //! The parameter name, '\0' terminated.
+    char* name;
+    //! Length of the parameter name.
+    size_t name_len;
+    //! The eval string: '{', the parameter name, '}' and a terminating '\0'.
+    char* eval_string;
+    //! Length of the eval string. Always name_len + 2.
+    size_t eval_len;
+    //! Non-zero once the parameter is known to exist. \sa y_param_exists()
+    int exists;
+    //! Non-zero if int_value holds the current content of the parameter. \sa y_param_set_int()
+    int int_valid;
+    //! The last value saved with y_param_set_int().
+    int int_value;
+    //! The content returned by the last y_param_get() call, allocated by lr_eval_string_ext().
+    char* buffer;
+};
+//! \brief A parameter handle. \sa y_param_resolve()
+typedef struct y_struct_param y_param;
+
+//! \cond internal_global
+//! INTERNAL: Hash buckets of the interned parameter name table. \sa y_intern_parameter_name()
+y_param* _y_param_names[Y_PARAM_NAME_BUCKETS];
+//! INTERNAL: Number of interned parameter names. \sa y_intern_parameter_name()
+int _y_param_name_count = 0;
+//! \endcond
+
+/*!
+\brief Calculate a 32-bit hash (FNV-1a) over a block of memory.
+\param [in] data The bytes to hash.
+\param [in] len The number of bytes.
+\returns The hash value.
+*/
+unsigned int y_hash_string(const char* data, size_t len)
+{
+    unsigned int hash = 2166136261u;
+    const unsigned char* p = (const unsigned char*) data;
+    const unsigned char* end = p + len;
+
+    while( p < end )
+    {
+        hash ^= *p++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+/*!
+\brief Look up a parameter name in the interned parameter name table, adding it if there is room for it.
+
+Used by y_intern_parameter_name() and y_param_resolve(). Scripts should not need to call this directly.
+
+\param [in] param_name The name of the parameter.
+\param [in] limit The maximum number of entries in the table. Zero or less means there is no limit.
+\returns The table entry, or NULL if the table is full.
+*/
+y_param* y_intern_parameter_name_core(const char* param_name, int limit)
+{
+    size_t len = strlen(param_name);
+    unsigned int hash = y_hash_string(param_name, len);
+    y_param** bucket = &_y_param_names[hash & (Y_PARAM_NAME_BUCKETS -1)];
+    y_param* entry;
+
+    for( entry = *bucket; entry != NULL; entry = entry->next )
+    {
+        if( entry->hash == hash && entry->name_len == len && memcmp(entry->name, param_name, len) == 0 )
+        {
+            return entry;
+        }
+    }
+
+    if( limit > 0 && _y_param_name_count >= limit )
+    {
+        return NULL;
+    }
+
+    // parameter name + "{}" + '\0' (end of string), followed by the parameter name + '\0'
+    entry = (y_param*) y_mem_alloc( sizeof(y_param) + len +3 + len +1 );
+    memset(entry, 0, sizeof(y_param));
+    entry->hash = hash;
+    entry->name_len = len;
+    entry->eval_len = len +2;
+    entry->eval_string = (char*)(entry +1);
+    entry->eval_string[0] = '{';
+    memcpy(entry->eval_string +1, param_name, len);
+    entry->eval_string[len +1] = '}';
+    entry->eval_string[len +2] = '\0';
+    entry->name = entry->eval_string + len +3;
+    memcpy(entry->name, param_name, len +1);
+
+    entry->next = *bucket;
+    *bucket = entry;
+    _y_param_name_count++;
+    return entry;
+}
+
+/*!
+\brief Look up a parameter name in the interned parameter name table, adding it if it isn't there yet.
+
+Most scripts use the same few dozen parameter names over and over again. Rather than building a fresh "{name}" string every time
+one of the ylib accessors is called, ylib builds it once and keeps it around for the rest of the test.
+
+\param [in] param_name The name of the parameter.
+\returns The table entry, or NULL if the table is full (see Y_PARAM_NAME_LIMIT).
+\sa y_get_interned_eval_string(), y_get_parameter()
+*/
+y_param* y_intern_parameter_name(const char* param_name)
+{
+    return y_intern_parameter_name_core(param_name, Y_PARAM_NAME_LIMIT);
+}
+
+/*!
+\brief Obtain the string required to fetch the contents of a parameter through lr_eval_string(), from the interned parameter name table.
+
+If the table is full the string is built in the arena instead, so callers should hold an arena mark for as long as they need the result.
+\param [in] param_name The parameter name to construct the eval text for.
+\param [out] eval_len Optional. If not NULL, receives the length of the eval string.
+\returns The eval string. Do not modify or free it.
+\sa y_intern_parameter_name(), y_arena_get_parameter_eval_string()
+*/
+const char* y_get_interned_eval_string(const char* param_name, size_t* eval_len)
+{
+    y_param* entry = y_intern_parameter_name(param_name);
+    char* result;
+
+    if( entry != NULL )
+    {
+        if( eval_len != NULL )
+        {
+            *eval_len = entry->eval_len;
+        }
+        return entry->eval_string;
+    }
+
+    result = y_arena_get_parameter_eval_string(param_name);
+    if( eval_len != NULL )
+    {
+        *eval_len = strlen(result);
+    }
+    return result;
+}
+
 /*!
 \brief Obtain the string required to fetch the contents of a parameter through lr_eval_string().
 \param [in] param_name The parameter name to construct the eval text for.
@@ -304,16 +825,17 @@ char* y_get_parameter_eval_string(const char *param_name)
 It would be nice if loadrunner had a builtin for this.
 \param [in] param_name The name of the parameter to 
 \returns non-zero (true) if the parameter is empty, zero (false) otherwise.
-\sa y_get_parameter_eval_string()
+\sa y_get_interned_eval_string()
 \author Floris Kraak
 */
 int y_is_empty_parameter(const char *param_name)
 {
-    char* param_eval_string = y_get_parameter_eval_string(param_name);
+    y_arena_mark mark = y_arena_get_mark();
+    const char* param_eval_string = y_get_interned_eval_string(param_name, NULL);
     char* param = lr_eval_string(param_eval_string);
     
     int result = *param == 0 || strcmp(param, param_eval_string) == 0;
-    free(param_eval_string);
+    y_arena_release(mark);
 
     return result;
 }
@@ -340,9 +862,9 @@ lr_message("Test: %s", test);
 */
 char* y_get_parameter(const char* param_name)
 {
-   char* tmp = y_get_parameter_eval_string(param_name);
-   char* parameter = lr_eval_string(tmp);
-   free(tmp);
+   y_arena_mark mark = y_arena_get_mark();
+   char* parameter = lr_eval_string(y_get_interned_eval_string(param_name, NULL));
+   y_arena_release(mark);
    
    return parameter;
 }
@@ -377,12 +899,13 @@ lr_message("Test: %s", test);
 */
 char* y_get_parameter_or_null(const char* param_name)
 {
-    char* param_eval_string = y_get_parameter_eval_string(param_name);
+    y_arena_mark mark = y_arena_get_mark();
+    const char* param_eval_string = y_get_interned_eval_string(param_name, NULL);
     char* param = lr_eval_string(param_eval_string);
 
     int exists = strcmp(param, param_eval_string) != 0; // Result doesn't match the param eval string (eg: '{param}')
     //lr_log_message("y_get_parameter_or_null for param_name %s, pre-eval string is %s, lr_eval_string result is %s, exists: %d", param_name, param_eval_string, param, exists);
-    free(param_eval_string);
+    y_arena_release(mark);
     //lr_abort();
 
 	return exists ? param: NULL;
@@ -447,12 +970,161 @@ char* y_get_parameter_ext(const char *source_param)
 {
     char* buffer;
     unsigned long size;
-    char* source = y_get_parameter_eval_string(source_param); // Puts the parameter name into parameter seperators { }.
-    lr_eval_string_ext(source, strlen(source), &buffer, &size, 0, 0, -1); // Evaluates the result and copy the data into buffer.
-    free(source);                                             // Free the intermediate parameter name.
+    size_t source_len;
+    y_arena_mark mark = y_arena_get_mark();
+    const char* source = y_get_interned_eval_string(source_param, &source_len); // The parameter name between parameter seperators { }.
+    lr_eval_string_ext(source, source_len, &buffer, &size, 0, 0, -1);     // Evaluates the result and copy the data into buffer.
+    y_arena_release(mark);                                    // Release the intermediate parameter name, if any.
     return buffer;
 }
 
+/*!
+\brief Resolve a parameter name into a parameter handle.
+
+A handle remembers everything ylib can know about a parameter without evaluating it: the eval string and it's length,
+whether the parameter is known to exist, and the last integer saved into it through the handle.
+Resolving the same name twice returns the same handle. Handles are never freed, so resolve them once (for example into a static variable)
+rather than creating them for an endless stream of unique names.
+
+\param [in] param_name The name of the parameter.
+\returns The handle for the parameter.
+
+\b Example:
+\code
+static y_param* counter = NULL;
+if( counter == NULL )
+    counter = y_param_resolve("Counter");
+y_param_set_int(counter, y_param_get_int(counter) +1);
+\endcode
+\sa y_param_get(), y_param_set(), y_param_exists(), y_param_get_int(), y_param_set_int()
+*/
+y_param* y_param_resolve(const char* param_name)
+{
+    return y_intern_parameter_name_core(param_name, 0);
+}
+
+/*!
+\brief Get the content of a parameter through it's handle. Binary safe.
+
+\param [in] param The parameter handle, as returned by y_param_resolve().
+\param [out] len Optional. If not NULL, receives the length of the content.
+\returns The content of the parameter, or NULL if the parameter does not exist.
+\warning The returned buffer belongs to the handle. It remains valid until the next call to y_param_get() for the same handle.
+\note Once a parameter is known to exist, the check against "{name}" is skipped. If the parameter is removed with lr_free_parameter(), use y_param_free() instead so the handle knows about it.
+\sa y_param_resolve(), y_param_exists(), y_get_parameter_or_null()
+*/
+char* y_param_get(y_param* param, size_t* len)
+{
+    unsigned long size;
+
+    if( param->buffer != NULL )
+    {
+        lr_eval_string_ext_free(&param->buffer);
+    }
+    lr_eval_string_ext(param->eval_string, param->eval_len, &param->buffer, &size, 0, 0, -1);
+
+    if( !param->exists )
+    {
+        // If the parameter doesn't exist lr_eval_string_ext() hands back the eval string itself.
+        if( size == param->eval_len && memcmp(param->buffer, param->eval_string, size) == 0 )
+        {
+            if( len != NULL )
+            {
+                *len = 0;
+            }
+            return NULL;
+        }
+        param->exists = 1;
+    }
+
+    if( len != NULL )
+    {
+        *len = size;
+    }
+    return param->buffer;
+}
+
+/*!
+\brief Save a block of data into a parameter through it's handle. Binary safe.
+\param [in] param The parameter handle, as returned by y_param_resolve().
+\param [in] buffer The data to save.
+\param [in] len The length of the data.
+\sa y_param_resolve(), y_param_get(), lr_save_var()
+*/
+void y_param_set(y_param* param, const char* buffer, size_t len)
+{
+    lr_save_var(buffer, len, 0, param->name);
+    param->exists = 1;
+    param->int_valid = 0;
+}
+
+/*!
+\brief Test if a parameter exists, through it's handle.
+
+Once a parameter has been seen to exist this no longer evaluates the parameter at all.
+\param [in] param The parameter handle, as returned by y_param_resolve().
+\returns non-zero (true) if the parameter exists, zero (false) otherwise.
+\sa y_param_resolve(), y_param_get(), y_param_free()
+*/
+int y_param_exists(y_param* param)
+{
+    return param->exists || y_param_get(param, NULL) != NULL;
+}
+
+/*!
+\brief Save an integer into a parameter through it's handle.
+
+The value is remembered by the handle, so a subsequent y_param_get_int() on the same handle does not need to evaluate the parameter.
+\param [in] param The parameter handle, as returned by y_param_resolve().
+\param [in] value The value to save.
+\sa y_param_resolve(), y_param_get_int(), lr_save_int()
+*/
+void y_param_set_int(y_param* param, int value)
+{
+    lr_save_int(value, param->name);
+    param->exists = 1;
+    param->int_valid = 1;
+    param->int_value = value;
+}
+
+/*!
+\brief Get the content of a parameter as an integer, through it's handle.
+
+If the value was saved with y_param_set_int() it is returned directly, without evaluating the parameter.
+\param [in] param The parameter handle, as returned by y_param_resolve().
+\returns The content of the parameter converted with atoi(), or 0 if the parameter does not exist.
+\warning Values saved into the same parameter without going through the handle (lr_save_string() and friends) are not seen by the cache.
+Use y_param_set() or y_param_set_int() for parameters read with this function.
+\sa y_param_resolve(), y_param_set_int()
+*/
+int y_param_get_int(y_param* param)
+{
+    char* value;
+
+    if( param->int_valid )
+    {
+        return param->int_value;
+    }
+    value = y_param_get(param, NULL);
+    return value != NULL ? atoi(value) : 0;
+}
+
+/*!
+\brief Free a parameter through it's handle, and forget everything the handle knows about it.
+\param [in] param The parameter handle, as returned by y_param_resolve().
+\sa y_param_resolve(), lr_free_parameter()
+*/
+void y_param_free(y_param* param)
+{
+    lr_free_parameter(param->name);
+    if( param->buffer != NULL )
+    {
+        lr_eval_string_ext_free(&param->buffer);
+    }
+    param->exists = 0;
+    param->int_valid = 0;
+}
+
 //! \}
 
 #endif // _Y_CORE_C_
@@ -0,0 +1,335 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_csv.c
+\brief Parse CSV data into one parameter array per column.
+
+Parses RFC 4180 CSV in a single pass: fields are separated by commas and records by line ends (LF or CRLF).
+Fields may be quoted with double quotes, in which case they can contain commas, line ends, and quotes (written as two double quotes).
+
+Each column ends up in it's own parameter array, so the result can go straight into y_array_merge(), y_array_grep(), y_array_pick_random() and friends.
+With a header row, the arrays are named after the columns: a column "order id" with prefix "ORDER" becomes {ORDER_order_id_1} .. {ORDER_order_id_count}.
+Characters that can't be used in a parameter name are replaced by underscores. If that gives two columns the same name, an error is logged.
+Without a header row the columns are numbered: {ORDER_1_1} is row 1 of column 1.
+A UTF-8 byte order mark at the start of the data is skipped.
+
+Short rows are padded with empty values, so all columns have the same number of rows. Fields beyond the number of columns are ignored, with a warning.
+Empty lines are skipped, except when there is only one column. Then an empty line is a row with an empty value.
+
+\b Example:
+\code
+// users.csv:
+// username,password
+// alice,"p,ss"
+// bob,secret
+y_csv_parse_file("users.csv", 1, "USER");       // {USER_username_2} is "bob", {USER_password_1} is "p,ss"
+y_array_merge("USER_username", "USER_password", ":", "CREDENTIALS");
+\endcode
+*/
+#ifndef _Y_CSV_C_
+//! \cond include_protection
+#define _Y_CSV_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_core.c"
+#include "y_string.c"
+#include "y_param_array.c"
+
+
+//! \cond internal_functions
+/*
+Read one field starting at *pos. Quoted fields are unquoted into arena memory.
+Sets *end_of_record when the field is the last one of a record. Returns the field.
+*/
+y_strview y_csv_read_field(y_strview text, size_t* pos, int* end_of_record)
+{
+    const char* p = text.ptr + *pos;
+    const char* end = text.ptr + text.len;
+    y_strview field;
+
+    if( p < end && *p == '"' )
+    {
+        const char* field_end = p + 1;
+        char* value;
+        size_t len = 0;
+
+        // Find the end of the field first, so only the field itself is allocated rather than the rest of the input.
+        for(;;)
+        {
+            const char* quote = (const char*) memchr(field_end, '"', end - field_end);
+            if( quote == NULL )
+            {
+                field_end = end;
+                break;
+            }
+            field_end = quote + 1;
+            if( field_end < end && *field_end == '"' )
+            {
+                field_end++;
+                continue;
+            }
+            break;
+        }
+        while( field_end < end && *field_end != ',' && *field_end != '\n' )
+            field_end++;
+        value = y_arena_alloc(field_end - p);
+
+        p++;
+        for(;;)
+        {
+            const char* quote = (const char*) memchr(p, '"', end - p);
+            if( quote == NULL )
+            {
+                lr_log_message("Warning: y_csv_parse(): Unterminated quoted field at offset %d", (*pos));
+                quote = end;
+            }
+            memcpy(value + len, p, quote - p);
+            len += quote - p;
+            p = quote < end ? quote + 1 : end;
+            if( p < end && *p == '"' )
+            {
+                value[len++] = '"';
+                p++;
+                continue;
+            }
+            break;
+        }
+        // Anything between the closing quote and the next separator is kept as it is.
+        while( p < end && *p != ',' && *p != '\n' )
+        {
+            if( !(*p == '\r' && (p + 1 >= end || p[1] == '\n')) )
+                value[len++] = *p;
+            p++;
+        }
+        field = y_strview_make(value, len);
+    }
+    else
+    {
+        const char* start = p;
+        while( p < end && *p != ',' && *p != '\n' )
+            p++;
+        field = y_strview_make(start, p - start);
+        if( field.len > 0 && (p >= end || *p == '\n') && field.ptr[field.len - 1] == '\r' )
+            field.len--;
+    }
+
+    *end_of_record = p >= end || *p == '\n';
+    *pos = p < end ? (size_t)(p - text.ptr) + 1 : text.len;
+    return field;
+}
+
+// Build the name of the parameter array for a column.
+char* y_csv_column_name(const char* column_prefix, y_strview header, int column)
+{
+    size_t prefix_len = strlen(column_prefix);
+    char* name = y_mem_alloc(prefix_len + header.len + 13);
+    size_t i;
+
+    if( header.len == 0 )
+    {
+        snprintf(name, prefix_len + 13, "%s_%d", column_prefix, column);
+        return name;
+    }
+    memcpy(name, column_prefix, prefix_len);
+    name[prefix_len] = '_';
+    for( i = 0; i < header.len; i++ )
+    {
+        char c = header.ptr[i];
+        name[prefix_len + 1 + i] = (isalnum((unsigned char)c) && !(c & 0x80)) ? c : '_';
+    }
+    name[prefix_len + 1 + header.len] = '\0';
+    return name;
+}
+
+// Parse CSV text into column arrays. Returns the number of data rows.
+int y_csv_parse_view(y_strview text, int has_header, const char* column_prefix)
+{
+    size_t pos = 0;
+    char** columns = NULL;
+    int column_count = -1;    // Not known until the first record has been read.
+    y_strview* fields = NULL;
+    int field_capacity = 0;
+    int rows = 0;
+    int warned = 0;
+    int i, j;
+
+    // Skip the byte order mark that some tools put at the start of UTF-8 files.
+    if( text.len >= 3 && memcmp(text.ptr, "\xEF\xBB\xBF", 3) == 0 )
+        pos = 3;
+
+    while( pos < text.len )
+    {
+        y_arena_mark mark = y_arena_get_mark();
+        int field_count = 0;
+        int end_of_record = 0;
+
+        // Read a record.
+        while( !end_of_record )
+        {
+            if( field_count == field_capacity )
+            {
+                field_capacity = field_capacity ? field_capacity * 2 : 16;
+                fields = (y_strview*) realloc(fields, field_capacity * sizeof(y_strview));
+                if( fields == NULL )
+                {
+                    lr_error_message("Out of memory in y_csv_parse()");
+                    lr_abort();
+                    y_arena_release(mark);
+                    return rows;
+                }
+            }
+            fields[field_count++] = y_csv_read_field(text, &pos, &end_of_record);
+        }
+        if( field_count == 1 && fields[0].len == 0 && column_count != 1 )
+        {
+            // Empty line. With a single column it's an empty value instead.
+            y_arena_release(mark);
+            continue;
+        }
+
+        if( column_count < 0 )
+        {
+            column_count = field_count;
+            columns = (char**) y_mem_alloc(column_count * sizeof(char*) + 1);
+            for( i = 0; i < column_count; i++ )
+            {
+                columns[i] = y_csv_column_name(column_prefix, has_header ? fields[i] : y_strview_make("", 0), i + 1);
+                for( j = 0; j < i; j++ )
+                {
+                    if( strcmp(columns[j], columns[i]) == 0 )
+                        lr_error_message("y_csv_parse(): Columns %d and %d both end up in parameter array %s. Column %d overwrites column %d.", j + 1, i + 1, columns[i], i + 1, j + 1);
+                }
+            }
+            if( has_header )
+            {
+                y_arena_release(mark);
+                continue;
+            }
+        }
+
+        rows++;
+        if( field_count > column_count && !warned )
+        {
+            lr_log_message("Warning: y_csv_parse(): Row %d has %d fields, but there are only %d columns. The extra fields are ignored.", rows, field_count, column_count);
+            warned = 1;
+        }
+        for( i = 0; i < column_count; i++ )
+        {
+            y_save_view(i < field_count ? fields[i] : y_strview_make("", 0), y_arena_array_element_name(columns[i], rows));
+        }
+        y_arena_release(mark);
+    }
+
+    for( i = 0; i < column_count; i++ )
+    {
+        y_array_save_count(rows, columns[i]);
+        free(columns[i]);
+    }
+    free(columns);
+    free(fields);
+    return rows;
+}
+//! \endcond
+
+
+/*!
+\brief Parse CSV data in a parameter into one parameter array per column.
+
+The data is parsed in a single pass, without intermediate copies. See y_csv.c for the details of the format and how the arrays are named.
+
+\param [in] source_param The parameter containing the CSV data. Binary safe.
+\param [in] has_header Non-zero if the first record holds the column names, zero if it's data.
+\param [in] column_prefix The prefix of the names of the column arrays.
+\returns The number of data rows, which is also the {..._count} of every column array. If the source parameter does not exist this logs an error and calls lr_abort().
+
+\b Example:
+\code
+web_reg_save_param("Export", "LB=", "RB=", "Search=Body", LAST);
+web_url("export", "URL=https://{Host}/orders/export.csv", LAST);
+y_csv_parse("Export", 1, "ORDER");        // {ORDER_id_1} .. {ORDER_id_count}, {ORDER_status_1} .. {ORDER_status_count}, ...
+y_array_grep("ORDER_status", "open", "OPEN_ORDERS");
+\endcode
+\sa y_csv_parse_file(), y_split_all_quoted(), y_array_merge()
+*/
+int y_csv_parse(const char* source_param, int has_header, const char* column_prefix)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview text = y_get_parameter_view(source_param);
+    int rows;
+
+    if( text.ptr == NULL )
+    {
+        lr_error_message("y_csv_parse(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+    rows = y_csv_parse_view(text, has_header, column_prefix);
+    y_arena_release(mark);
+    return rows;
+}
+
+/*!
+\brief Parse a CSV file into one parameter array per column.
+
+As y_csv_parse(), but the data is read from a file. The file is read into memory in one go and parsed from there;
+it is not saved into a parameter first.
+
+\param [in] filename The name of the CSV file (relative to script root, or full path).
+\param [in] has_header Non-zero if the first record holds the column names, zero if it's data.
+\param [in] column_prefix The prefix of the names of the column arrays.
+\returns The number of data rows. If the file cannot be read this logs an error and calls lr_abort().
+\sa y_csv_parse()
+*/
+int y_csv_parse_file(const char* filename, int has_header, const char* column_prefix)
+{
+    long f;
+    long size;
+    char* data;
+    int rows;
+
+    if( (f = fopen(filename, "rb")) == NULL )
+    {
+        lr_error_message("y_csv_parse_file(): Unable to open file %s", filename);
+        lr_abort();
+        return 0;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    data = y_mem_alloc(size + 1);
+    size = fread(data, 1, size, f);
+    fclose(f);
+
+    rows = y_csv_parse_view(y_strview_make(data, size), has_header, column_prefix);
+    free(data);
+    lr_log_message("y_csv_parse_file(): Read %d rows from %s", rows, filename);
+    return rows;
+}
+
+#endif // _Y_CSV_C_
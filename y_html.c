@@ -0,0 +1,769 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_html.c
+\brief Single pass extraction of data from HTML pages.
+
+Correlating an HTML page the usual way means one web_reg_save_param() or y_substr() per value, each of which scans the page from the start.
+The functions in this file walk the tags of a page once, from start to end, and pick up everything they need on the way.
+
+The tag scanner is forgiving in the way browsers are: tag and attribute names are case insensitive, attribute values may be quoted or not,
+and missing end tags are not an error. Comments and the content of script and style elements are skipped.
+Entities in the extracted values are decoded.
+*/
+#ifndef _Y_HTML_C_
+//! \cond include_protection
+#define _Y_HTML_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_core.c"
+#include "y_string.c"
+#include "y_param_array.c"
+#include "y_codec.c"
+
+//! \brief A tag found by the HTML tag scanner. \sa y_html_next_tag()
+struct y_struct_html_tag
+{
+    //! The start of the tag (the '<').
+    const char* start;
+    //! The position just after the '>' that closes the tag.
+    const char* end;
+    //! The name of the tag, without the '<' or '/'.
+    y_strview name;
+    //! 1 for end tags, 0 for start tags.
+    int closing;
+    //! The attribute text: everything between the name and the '>'.
+    y_strview attributes;
+};
+//! \brief A tag found by the HTML tag scanner. \sa y_html_next_tag()
+typedef struct y_struct_html_tag y_html_tag;
+
+
+//! \cond internal_functions
+int y_html_is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f';
+}
+
+// Compare a tag or attribute name to a lowercase name, case insensitively.
+int y_html_name_is(y_strview name, const char* lowercase_name)
+{
+    size_t i;
+
+    for( i = 0; i < name.len; i++ )
+    {
+        if( lowercase_name[i] == '\0' || tolower((unsigned char)name.ptr[i]) != lowercase_name[i] )
+            return 0;
+    }
+    return lowercase_name[i] == '\0';
+}
+
+/*
+Read the next attribute from the attribute text of a tag, starting at p.
+Attributes without a value ("checked") get an empty value view with a non-NULL ptr.
+Returns the position after the attribute, or NULL if there are no more attributes.
+*/
+const char* y_html_next_attribute(const char* p, const char* end, y_strview* name, y_strview* value)
+{
+    const char* start;
+
+    while( p < end && (y_html_is_space(*p) || *p == '/') )
+        p++;
+    if( p >= end || *p == '>' )
+        return NULL;
+
+    start = p;
+    while( p < end && !y_html_is_space(*p) && *p != '/' && *p != '>' && *p != '=' )
+        p++;
+    if( p == start )
+        p++; // A stray '=' - treat it as an attribute name on its own.
+    *name = y_strview_make(start, p - start);
+
+    while( p < end && y_html_is_space(*p) )
+        p++;
+    if( p >= end || *p != '=' )
+    {
+        *value = y_strview_make(start, 0);
+        return p;
+    }
+    p++;
+    while( p < end && y_html_is_space(*p) )
+        p++;
+
+    if( p < end && (*p == '"' || *p == '\'') )
+    {
+        const char* close = (const char*) memchr(p + 1, *p, end - p - 1);
+        if( close == NULL )
+            close = end;
+        *value = y_strview_make(p + 1, close - p - 1);
+        return close < end ? close + 1 : end;
+    }
+    start = p;
+    while( p < end && !y_html_is_space(*p) && *p != '>' )
+        p++;
+    *value = y_strview_make(start, p - start);
+    return p;
+}
+
+/*
+Find the next tag at or after p, and fill in tag.
+Comments, doctype declarations and processing instructions are skipped over.
+Returns the position to continue scanning from, or NULL if there are no more tags.
+For script, style and textarea elements this is the start of the end tag rather than tag->end, so their content is skipped.
+The content of a textarea is what lies between tag->end and the returned position.
+*/
+const char* y_html_next_tag(const char* p, const char* end, y_html_tag* tag)
+{
+    while( p < end && (p = (const char*) memchr(p, '<', end - p)) != NULL )
+    {
+        const char* name;
+        const char* q;
+        const char* raw;
+        y_strview attribute_name;
+        y_strview attribute_value;
+
+        if( end - p >= 4 && strncmp(p, "<!--", 4) == 0 )
+        {
+            p = y_find(p + 4, end - p - 4, "-->", 3);
+            if( p == NULL )
+                return NULL;
+            p += 3;
+            continue;
+        }
+        if( end - p >= 2 && (p[1] == '!' || p[1] == '?') )
+        {
+            p = (const char*) memchr(p, '>', end - p);
+            if( p == NULL )
+                return NULL;
+            p++;
+            continue;
+        }
+
+        tag->start = p;
+        tag->closing = end - p >= 2 && p[1] == '/';
+        name = p + 1 + tag->closing;
+        if( name >= end || !isalpha((unsigned char)*name) )
+        {
+            // Not a tag, just a '<' in the text.
+            p++;
+            continue;
+        }
+        q = name;
+        while( q < end && !y_html_is_space(*q) && *q != '/' && *q != '>' )
+            q++;
+        tag->name = y_strview_make(name, q - name);
+
+        // Walk the attributes to find the end of the tag, so a '>' in a quoted attribute value doesn't end it.
+        p = q;
+        while( (q = y_html_next_attribute(p, end, &attribute_name, &attribute_value)) != NULL )
+            p = q;
+        while( p < end && *p != '>' )
+            p++;
+        if( p >= end )
+            return NULL;
+        tag->attributes = y_strview_make(tag->name.ptr + tag->name.len, p - tag->name.ptr - tag->name.len);
+        tag->end = p + 1;
+
+        raw = y_html_name_is(tag->name, "script") ? "script" : y_html_name_is(tag->name, "style") ? "style" : y_html_name_is(tag->name, "textarea") ? "textarea" : NULL;
+        if( !tag->closing && raw != NULL )
+        {
+            // Raw text: skip ahead to the matching end tag.
+            size_t raw_len = strlen(raw);
+            for( q = tag->end; (q = (const char*) memchr(q, '<', end - q)) != NULL; q++ )
+            {
+                if( (size_t)(end - q) >= raw_len + 2 && q[1] == '/' && y_html_name_is(y_strview_make(q + 2, raw_len), raw) )
+                    return q;
+            }
+            return end;
+        }
+        return tag->end;
+    }
+    return NULL;
+}
+
+/*
+Look up an attribute of a tag by (lowercase) name.
+Returns a view on the raw value, entities not decoded. If the tag doesn't have the attribute the ptr member of the view is NULL.
+*/
+y_strview y_html_tag_attribute(const y_html_tag* tag, const char* lowercase_name)
+{
+    const char* p = tag->attributes.ptr;
+    const char* end = tag->attributes.ptr + tag->attributes.len;
+    y_strview name;
+    y_strview value;
+
+    while( (p = y_html_next_attribute(p, end, &name, &value)) != NULL )
+    {
+        if( y_html_name_is(name, lowercase_name) )
+            return value;
+    }
+    return y_strview_make(NULL, 0);
+}
+
+// Save a value into an element of a parameter array, decoding entities in it.
+void y_html_save_element(const char* param_array, int index, y_strview value)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    const char* name = y_arena_array_element_name(param_array, index);
+
+    if( value.len && memchr(value.ptr, '&', value.len) != NULL )
+    {
+        char* decoded = y_arena_alloc(value.len + 1);
+        value = y_strview_make(decoded, y_html_unescape_buffer(value, decoded));
+    }
+    lr_save_var(value.len ? value.ptr : "", value.len, 0, name);
+    y_arena_release(mark);
+}
+
+/*
+Append text found between two tags to a cell buffer, the way a browser renders it:
+runs of whitespace become a single space, and comments are left out.
+*/
+void y_html_append_text(y_strbuf* buf, const char* p, const char* end)
+{
+    while( p < end )
+    {
+        const char* q = p;
+
+        if( y_html_is_space(*p) )
+        {
+            while( p < end && y_html_is_space(*p) )
+                p++;
+            if( buf->len > 0 && buf->data[buf->len - 1] != ' ' )
+                y_strbuf_append_bytes(buf, " ", 1);
+            continue;
+        }
+        if( *p == '<' && end - p >= 2 && (p[1] == '!' || p[1] == '?') )
+        {
+            if( end - p >= 4 && strncmp(p, "<!--", 4) == 0 )
+            {
+                q = y_find(p + 4, end - p - 4, "-->", 3);
+                p = q != NULL ? q + 3 : end;
+            }
+            else
+            {
+                q = (const char*) memchr(p, '>', end - p);
+                p = q != NULL ? q + 1 : end;
+            }
+            continue;
+        }
+        while( q < end && !y_html_is_space(*q) && *q != '<' )
+            q++;
+        if( q == p )
+            q++;    // A '<' that doesn't start a comment.
+        y_strbuf_append_bytes(buf, p, q - p);
+        p = q;
+    }
+}
+
+// The number of columns a table cell spans.
+int y_table_colspan(const y_html_tag* tag)
+{
+    y_strview colspan = y_html_tag_attribute(tag, "colspan");
+    char digits[12];
+    size_t len = colspan.len < sizeof(digits) - 1 ? colspan.len : sizeof(digits) - 1;
+    int span;
+
+    if( len == 0 )
+        return 1;
+    memcpy(digits, colspan.ptr, len);
+    digits[len] = '\0';
+    span = atoi(digits);
+    if( span < 1 )
+        return 1;
+    return span > 1000 ? 1000 : span;    // 1000 is the limit browsers use.
+}
+
+// Save a table cell as {prefix_row_column}, and optionally as element row of the column array {prefix_col_column}.
+void y_table_save_cell(const char* prefix, int row, int column, y_strview value, int column_arrays)
+{
+    y_arena_mark mark = y_arena_get_mark();
+
+    y_html_save_element(y_arena_array_element_name(prefix, row), column, value);
+    if( column_arrays )
+    {
+        size_t size = strlen(prefix) + 17;    // 17 = "_col_" + up to 11 characters for the column + '\0'
+        char* column_array = y_arena_alloc(size);
+        snprintf(column_array, size, "%s_col_%d", prefix, column);
+        y_html_save_element(column_array, row, value);
+    }
+    y_arena_release(mark);
+}
+
+// Save the text collected for a cell. Columns spanned by the cell are left empty, so the cells after it line up.
+void y_table_end_cell(const char* prefix, int row, int column, int span, y_strbuf* cell, int column_arrays)
+{
+    int c;
+
+    y_table_save_cell(prefix, row, column, y_strview_trim(y_strview_make(cell->data, cell->len)), column_arrays);
+    for( c = column + 1; c < column + span; c++ )
+        y_table_save_cell(prefix, row, c, y_strview_make("", 0), column_arrays);
+}
+//! \endcond
+
+
+/*!
+\brief Extract the name and value of every field of an HTML form in a single pass.
+
+The page is scanned once, and the fields are saved into two parameter arrays: one containing the field names and one containing the values, in the order in which they appear on the page.
+The arrays can be fed straight into y_array_merge() to build a request body, or searched with y_array_grep() and friends.
+
+The fields are picked up the way a browser would submit them:
+- input elements of any type except reset, button, file and image. This includes hidden fields such as __VIEWSTATE and __EVENTVALIDATION, and submit buttons.
+- checkboxes and radio buttons only when they are checked. Without a value attribute their value is "on".
+- the selected option(s) of a select element, or the first option of a single select element if none are selected.
+- the text in a textarea.
+
+Fields without a name, and disabled fields, are skipped. Entities in names and values are decoded.
+
+\param [in] source_param The parameter containing the HTML page.
+\param [in] form_selector The id or name of the form to extract the fields from. Only the first matching form is used. If this is NULL or empty, the fields of all forms on the page are extracted.
+\param [in] names_array The name of the parameter array to save the field names in.
+\param [in] values_array The name of the parameter array to save the field values in.
+\returns The number of fields found. If the source parameter does not exist this logs an error and calls lr_abort().
+
+\b Example:
+\code
+web_reg_save_param("Page", "LB=", "RB=", "Search=Body", LAST);
+web_url("login", "URL=https://{Host}/Login.aspx", LAST);
+
+y_form_extract("Page", "form1", "FieldName", "FieldValue");   // {FieldName_1} is "__VIEWSTATE", {FieldValue_1} the view state itself, ...
+y_array_merge("FieldName", "FieldValue", "=", "Field");       // {Field_1} is "__VIEWSTATE=..."
+\endcode
+\sa y_array_merge(), y_array_split(), y_array_grep()
+*/
+int y_form_extract(const char* source_param, const char* form_selector, const char* names_array, const char* values_array)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview page = y_get_parameter_view(source_param);
+    int all_forms = form_selector == NULL || form_selector[0] == '\0';
+    int in_form = all_forms;
+    int count = 0;
+    const char* p;
+    const char* next;
+    const char* end;
+    y_html_tag tag;
+
+    // State for the select element we're in, if any.
+    y_strview select_name = y_strview_make(NULL, 0);
+    int select_multiple = 0;
+    int select_saved = 0;
+    y_strview first_option = y_strview_make(NULL, 0);
+    // An option without a value attribute, waiting for the next tag to find the end of its text.
+    const char* option_text = NULL;
+    int option_selected = 0;
+
+    if( page.ptr == NULL )
+    {
+        lr_error_message("y_form_extract(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return -1;
+    }
+    p = page.ptr;
+    end = page.ptr + page.len;
+
+    while( (next = y_html_next_tag(p, end, &tag)) != NULL )
+    {
+        y_strview name;
+        p = next;
+
+        // The text of an option ends at the next tag, whatever that is.
+        if( option_text != NULL )
+        {
+            y_strview value = y_strview_trim(y_strview_make(option_text, tag.start - option_text));
+            if( option_selected )
+            {
+                y_html_save_element(names_array, ++count, select_name);
+                y_html_save_element(values_array, count, value);
+                select_saved = 1;
+            }
+            else if( first_option.ptr == NULL )
+                first_option = value;
+            option_text = NULL;
+        }
+
+        if( y_html_name_is(tag.name, "form") )
+        {
+            if( !all_forms && !tag.closing )
+            {
+                in_form = y_strview_equals(y_html_tag_attribute(&tag, "id"), y_strview_from_string(form_selector))
+                       || y_strview_equals(y_html_tag_attribute(&tag, "name"), y_strview_from_string(form_selector));
+            }
+            else if( !all_forms && in_form )
+                break;
+            continue;
+        }
+        if( !in_form )
+            continue;
+
+        if( y_html_name_is(tag.name, "select") )
+        {
+            // A select ends at its end tag, or where the next one starts.
+            if( select_name.ptr != NULL && !select_saved && !select_multiple && first_option.ptr != NULL )
+            {
+                y_html_save_element(names_array, ++count, select_name);
+                y_html_save_element(values_array, count, first_option);
+            }
+            select_name = y_strview_make(NULL, 0);
+            select_saved = 0;
+            first_option = y_strview_make(NULL, 0);
+            if( !tag.closing && y_html_tag_attribute(&tag, "disabled").ptr == NULL )
+            {
+                select_name = y_html_tag_attribute(&tag, "name");
+                if( select_name.len == 0 )
+                    select_name.ptr = NULL;
+                select_multiple = y_html_tag_attribute(&tag, "multiple").ptr != NULL;
+            }
+            continue;
+        }
+        if( tag.closing )
+            continue;
+
+        if( y_html_name_is(tag.name, "option") )
+        {
+            y_strview value;
+            if( select_name.ptr == NULL || y_html_tag_attribute(&tag, "disabled").ptr != NULL )
+                continue;
+            option_selected = y_html_tag_attribute(&tag, "selected").ptr != NULL;
+            value = y_html_tag_attribute(&tag, "value");
+            if( value.ptr == NULL )
+                option_text = tag.end;
+            else if( option_selected )
+            {
+                y_html_save_element(names_array, ++count, select_name);
+                y_html_save_element(values_array, count, value);
+                select_saved = 1;
+            }
+            else if( first_option.ptr == NULL )
+                first_option = value;
+            continue;
+        }
+
+        if( !y_html_name_is(tag.name, "input") && !y_html_name_is(tag.name, "textarea") )
+            continue;
+        name = y_html_tag_attribute(&tag, "name");
+        if( name.len == 0 || y_html_tag_attribute(&tag, "disabled").ptr != NULL )
+            continue;
+
+        if( y_html_name_is(tag.name, "input") )
+        {
+            y_strview type = y_html_tag_attribute(&tag, "type");
+            y_strview value = y_html_tag_attribute(&tag, "value");
+
+            if( y_html_name_is(type, "reset") || y_html_name_is(type, "button") || y_html_name_is(type, "file") || y_html_name_is(type, "image") )
+                continue;
+            if( y_html_name_is(type, "checkbox") || y_html_name_is(type, "radio") )
+            {
+                if( y_html_tag_attribute(&tag, "checked").ptr == NULL )
+                    continue;
+                if( value.ptr == NULL )
+                    value = y_strview_from_string("on");
+            }
+            y_html_save_element(names_array, ++count, name);
+            y_html_save_element(values_array, count, value);
+        }
+        else
+        {
+            // A newline straight after the start tag is not part of the text.
+            const char* text = tag.end;
+            if( text < p && *text == '\r' )
+                text++;
+            if( text < p && *text == '\n' )
+                text++;
+            y_html_save_element(names_array, ++count, name);
+            y_html_save_element(values_array, count, y_strview_make(text, p - text));
+        }
+    }
+
+    // A select that was still open at the end of the form or page.
+    if( option_text != NULL )
+    {
+        y_strview value = y_strview_trim(y_strview_make(option_text, end - option_text));
+        if( option_selected )
+        {
+            y_html_save_element(names_array, ++count, select_name);
+            y_html_save_element(values_array, count, value);
+            select_saved = 1;
+        }
+        else if( first_option.ptr == NULL )
+            first_option = value;
+    }
+    if( select_name.ptr != NULL && !select_saved && !select_multiple && first_option.ptr != NULL )
+    {
+        y_html_save_element(names_array, ++count, select_name);
+        y_html_save_element(values_array, count, first_option);
+    }
+
+    y_array_save_count(count, names_array);
+    y_array_save_count(count, values_array);
+    y_arena_release(mark);
+    return count;
+}
+
+//! \cond internal_functions
+// The table walk behind y_table_extract() and y_table_extract_columns().
+int y_table_extract_core(const char* source_param, const char* table_lb, const char* result_prefix, int column_arrays)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview page = y_get_parameter_view(source_param);
+    const char* p;
+    const char* next;
+    const char* end;
+    y_html_tag tag;
+    int depth = 0;
+    y_strbuf cell;
+    int in_cell = 0;
+    int cell_column = 0;
+    int cell_span = 1;
+    int rows = 0;
+    int columns = 0;
+    int column = 0;          // The number of columns filled in the current row. 0 if the row has no cells (yet).
+    int* row_lengths = NULL;
+    int row_capacity = 0;
+    int r;
+    int c;
+
+    if( page.ptr == NULL )
+    {
+        lr_error_message("y_table_extract(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return -1;
+    }
+    p = page.ptr;
+    end = page.ptr + page.len;
+
+    // Find the table.
+    if( table_lb != NULL && table_lb[0] != '\0' )
+    {
+        const char* match = y_find(p, end - p, table_lb, strlen(table_lb));
+
+        // If the text is part of a tag, such as id="orders" in the table tag itself, start at that tag.
+        for( p = match; p != NULL && p > page.ptr && p[-1] != '>'; p-- )
+        {
+            if( p[-1] == '<' )
+            {
+                p--;
+                break;
+            }
+        }
+        if( p != NULL && *p != '<' )
+            p = match + strlen(table_lb);
+    }
+    while( p != NULL && (next = y_html_next_tag(p, end, &tag)) != NULL )
+    {
+        p = next;
+        if( !tag.closing && y_html_name_is(tag.name, "table") )
+        {
+            depth = 1;
+            break;
+        }
+    }
+    if( depth == 0 )
+    {
+        lr_log_message("Warning: y_table_extract(): No table found in parameter %s%s%s", source_param, table_lb != NULL && table_lb[0] != '\0' ? " after " : "", table_lb != NULL ? table_lb : "");
+        p = end;
+    }
+
+    y_strbuf_init(&cell, 0);
+    while( depth > 0 && (next = y_html_next_tag(p, end, &tag)) != NULL )
+    {
+        int is_cell;
+
+        if( in_cell )
+        {
+            y_html_append_text(&cell, p, tag.start);
+            // Line breaks and block elements inside a cell separate words.
+            if( y_html_name_is(tag.name, "br") || y_html_name_is(tag.name, "p") || y_html_name_is(tag.name, "div") || y_html_name_is(tag.name, "li")
+                || y_html_name_is(tag.name, "td") || y_html_name_is(tag.name, "th") || y_html_name_is(tag.name, "tr") )
+            {
+                if( cell.len > 0 && cell.data[cell.len - 1] != ' ' )
+                    y_strbuf_append_bytes(&cell, " ", 1);
+            }
+        }
+        p = next;
+
+        // Tags of nested tables are just part of the text of the cell they're in.
+        if( y_html_name_is(tag.name, "table") )
+        {
+            depth += tag.closing ? -1 : 1;
+            if( depth > 0 )
+                continue;
+        }
+        else if( depth > 1 )
+            continue;
+
+        is_cell = y_html_name_is(tag.name, "td") || y_html_name_is(tag.name, "th");
+        if( depth > 0 && !is_cell && !y_html_name_is(tag.name, "tr") && !y_html_name_is(tag.name, "thead") && !y_html_name_is(tag.name, "tbody")
+            && !y_html_name_is(tag.name, "tfoot") && !y_html_name_is(tag.name, "caption") )
+            continue;    // Inline markup.
+
+        // Any table structure ends the current cell.
+        if( in_cell )
+        {
+            y_table_end_cell(result_prefix, rows, cell_column, cell_span, &cell, column_arrays);
+            in_cell = 0;
+        }
+        if( !is_cell )
+        {
+            // Rows, sections and the end of the table end the current row.
+            column = 0;
+            continue;
+        }
+        if( tag.closing )
+            continue;
+
+        if( column == 0 )
+        {
+            // First cell of a new row. Rows without any cells are not counted.
+            if( rows == row_capacity )
+            {
+                row_capacity = row_capacity ? row_capacity * 2 : 64;
+                row_lengths = (int*) realloc(row_lengths, row_capacity * sizeof(int));
+                if( row_lengths == NULL )
+                {
+                    lr_error_message("Out of memory in y_table_extract()");
+                    lr_abort();
+                    y_strbuf_free(&cell);
+                    y_arena_release(mark);
+                    return -1;
+                }
+            }
+            rows++;
+        }
+        cell_column = column + 1;
+        cell_span = y_table_colspan(&tag);
+        column = row_lengths[rows - 1] = cell_column + cell_span - 1;
+        in_cell = 1;
+        y_strbuf_reset(&cell);
+    }
+    // A table that isn't closed before the end of the page.
+    if( in_cell )
+    {
+        y_html_append_text(&cell, p, end);
+        y_table_end_cell(result_prefix, rows, cell_column, cell_span, &cell, column_arrays);
+    }
+    y_strbuf_free(&cell);
+
+    // Pad short rows, so every row has the same number of columns.
+    for( r = 0; r < rows; r++ )
+    {
+        if( row_lengths[r] > columns )
+            columns = row_lengths[r];
+    }
+    for( r = 1; r <= rows; r++ )
+    {
+        y_arena_mark row_mark = y_arena_get_mark();
+
+        for( c = row_lengths[r - 1] + 1; c <= columns; c++ )
+            y_table_save_cell(result_prefix, r, c, y_strview_make("", 0), column_arrays);
+        y_array_save_count(columns, y_arena_array_element_name(result_prefix, r));
+        y_arena_release(row_mark);
+    }
+    if( column_arrays )
+    {
+        size_t size = strlen(result_prefix) + 17;
+        char* column_array = y_arena_alloc(size);
+        for( c = 1; c <= columns; c++ )
+        {
+            snprintf(column_array, size, "%s_col_%d", result_prefix, c);
+            y_array_save_count(rows, column_array);
+        }
+    }
+    free(row_lengths);
+
+    {
+        size_t size = strlen(result_prefix) + 6;    // 6 = strlen("_rows") + 1
+        char* name = y_arena_alloc(size);
+        snprintf(name, size, "%s_rows", result_prefix);
+        lr_save_int(rows, name);
+        snprintf(name, size, "%s_cols", result_prefix);
+        lr_save_int(columns, name);
+    }
+    y_arena_release(mark);
+    return rows;
+}
+//! \endcond
+
+
+/*!
+\brief Extract the cells of an HTML table into a two dimensional grid of parameters, in a single pass.
+
+The table is walked once, and each cell is saved as {result_prefix_row_column}, counting from 1. {result_prefix_rows} and {result_prefix_cols} hold the size of the grid.
+Each row is also a parameter array in its own right: {result_prefix_2_count} is the number of columns, so y_array_pick_random("PREFIX_2") and friends work on it.
+
+The text of a cell is what a browser would show: tags are stripped, whitespace is collapsed, and entities are decoded.
+Header cells (th) are treated the same as data cells, so a header row ends up as row 1.
+Cells spanning multiple columns (colspan) are stored in their first column; the columns they span are left empty, so the cells after them line up. Row spans are not taken into account.
+Rows without any cells are skipped, and short rows are padded with empty cells. Tables nested inside a cell are part of the text of that cell.
+
+\param [in] source_param The parameter containing the HTML page.
+\param [in] table_lb The text to look for before the table. The first table starting after it is used; if the text is part of a tag, such as id="orders" in the table tag itself, that tag is included. If this is NULL or empty, the first table on the page is used.
+\param [in] result_prefix The prefix of the names of the parameters to save the cells in.
+\returns The number of rows. If no table was found, this logs a warning and saves an empty grid. If the source parameter does not exist this logs an error and calls lr_abort().
+
+\b Example:
+\code
+web_reg_save_param("Page", "LB=", "RB=", "Search=Body", LAST);
+web_url("orders", "URL=https://{Host}/Orders.aspx", LAST);
+
+y_table_extract("Page", "id=\"orderGrid\"", "Order");   // {Order_1_1} is the first header, {Order_2_3} the third column of the first order, ...
+lr_message("The grid has %d rows and %d columns", atoi(lr_eval_string("{Order_rows}")), atoi(lr_eval_string("{Order_cols}")));
+\endcode
+\sa y_table_extract_columns(), y_form_extract()
+*/
+int y_table_extract(const char* source_param, const char* table_lb, const char* result_prefix)
+{
+    return y_table_extract_core(source_param, table_lb, result_prefix, 0);
+}
+
+/*!
+\brief Extract the cells of an HTML table into a grid of parameters, and one parameter array per column.
+
+As y_table_extract(), but each column is also saved as a parameter array, in the same pass: {result_prefix_col_3_1} .. {result_prefix_col_3_count} hold the third column.
+These can go straight into y_array_grep(), y_array_merge(), y_array_pick_random() and friends.
+
+\param [in] source_param The parameter containing the HTML page.
+\param [in] table_lb The text to look for before the table. If this is NULL or empty, the first table on the page is used.
+\param [in] result_prefix The prefix of the names of the parameters to save the cells in.
+\returns The number of rows, which is also the {..._count} of every column array.
+
+\b Example:
+\code
+y_table_extract_columns("Page", "id=\"orderGrid\"", "Order");
+y_array_grep("Order_col_4", "Open", "OpenOrderStatus");
+y_array_pick_random("Order_col_1");      // A random order number. Note that row 1 is the header row.
+\endcode
+\sa y_table_extract()
+*/
+int y_table_extract_columns(const char* source_param, const char* table_lb, const char* result_prefix)
+{
+    return y_table_extract_core(source_param, table_lb, result_prefix, 1);
+}
+
+#endif // _Y_HTML_C_
@@ -0,0 +1,1202 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_json.c
+\brief JSON support: extracting values by path, and building documents.
+
+y_json_get() and friends walk a JSON document once, from start to end, without building a tree out of it.
+Values found at the requested paths are saved into parameters or parameter arrays on the way.
+Parts of the document that no path can match are skipped over without looking at their content.
+
+Paths use a small subset of the JSONPath syntax:
+- $ is the document itself. It may be left out.
+- .name or ['name'] selects a member of an object.
+- [N] selects the Nth element of an array, counting from 0.
+- [*] or .* selects all elements of an array, or all members of an object.
+
+Matched strings are saved without their quotes, with escape sequences decoded. \\u escapes are decoded to UTF-8.
+Numbers, true, false and null are saved as they appear in the document. Matched objects and arrays are saved as JSON text.
+
+\b Example:
+\code
+// {Body} contains {"orders":[{"id":1,"lines":[{"sku":"A"}]},{"id":2,"lines":[{"sku":"B"},{"sku":"C"}]}]}
+y_json_get("Body", "$.orders[*].id", "OrderId");           // {OrderId_1} is "1", {OrderId_2} is "2", {OrderId_count} is 2
+y_json_get("Body", "$.orders[*].lines[*].sku", "Sku");      // {Sku_1} .. {Sku_3} are "A", "B" and "C"
+y_json_get_value("Body", "$.orders[1].lines[0]", "Line");   // {Line} is {"sku":"B"}
+\endcode
+
+To build a document, use a y_json_writer.
+*/
+#ifndef _Y_JSON_C_
+//! \cond include_protection
+#define _Y_JSON_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_string.c"
+#include "y_param_array.c"
+
+//! \brief The maximum number of segments in a JSON path.
+#define Y_JSON_MAX_PATH_DEPTH 32
+//! \brief The maximum number of paths y_json_get_multi() can match in one pass.
+#define Y_JSON_MAX_PATHS 32
+
+//! \cond internal_global
+// Path segment types.
+#define Y_JSON_SEGMENT_MEMBER 1
+#define Y_JSON_SEGMENT_INDEX 2
+#define Y_JSON_SEGMENT_WILDCARD 3
+//! \endcond
+
+//! \brief A single step in a JSON path. \sa y_struct_json_path
+struct y_struct_json_segment
+{
+    //! One of the Y_JSON_SEGMENT_* types.
+    int type;
+    //! For members: the name of the member.
+    y_strview name;
+    //! For array elements: the index.
+    int index;
+};
+//! \brief A single step in a JSON path.
+typedef struct y_struct_json_segment y_json_segment;
+
+//! \brief A parsed JSON path, and where to save the values that match it. \sa y_json_get_multi()
+struct y_struct_json_path
+{
+    //! The path as given.
+    const char* path;
+    //! The steps of the path.
+    y_json_segment segments[Y_JSON_MAX_PATH_DEPTH];
+    //! The number of steps.
+    int depth;
+    //! The parameter or parameter array to save matches in.
+    const char* result;
+    //! Non-zero to save only the first match, as a single parameter.
+    int single;
+    //! The number of matches so far.
+    int count;
+};
+//! \brief A parsed JSON path.
+typedef struct y_struct_json_path y_json_path;
+
+//! \brief State of a pass over a JSON document.
+struct y_struct_json_scanner
+{
+    //! The current position.
+    const char* pos;
+    //! The end of the document.
+    const char* end;
+    //! The start of the document, for error messages.
+    const char* start;
+    //! The paths to match.
+    y_json_path* paths;
+    //! The number of paths.
+    int path_count;
+    //! Paths that still need matches. Once this is 0 the scan can stop early.
+    unsigned int wanted;
+    //! Set when the scan stopped early, leaving the rest of the document unread.
+    int stopped;
+    //! The error message, or NULL.
+    const char* error;
+};
+//! \brief State of a pass over a JSON document.
+typedef struct y_struct_json_scanner y_json_scanner;
+
+
+//! \cond internal_functions
+// Parse a path. Returns 0 and logs an error if the path is invalid.
+int y_json_parse_path(const char* path, y_json_path* result)
+{
+    const char* p = path;
+
+    result->path = path;
+    result->depth = 0;
+    result->count = 0;
+    if( *p == '$' )
+        p++;
+
+    while( *p != '\0' )
+    {
+        y_json_segment* segment = &result->segments[result->depth];
+
+        if( result->depth >= Y_JSON_MAX_PATH_DEPTH )
+        {
+            lr_error_message("y_json: Path too deep: %s", path);
+            return 0;
+        }
+
+        if( *p == '.' || (p == path && *p != '[') )
+        {
+            const char* name = (*p == '.') ? ++p : p;
+            while( *p != '\0' && *p != '.' && *p != '[' )
+                p++;
+            if( p == name )
+            {
+                lr_error_message("y_json: Empty member name in path %s", path);
+                return 0;
+            }
+            segment->type = (p - name == 1 && *name == '*') ? Y_JSON_SEGMENT_WILDCARD : Y_JSON_SEGMENT_MEMBER;
+            segment->name = y_strview_make(name, p - name);
+        }
+        else if( *p == '[' && (p[1] == '\'' || p[1] == '"') )
+        {
+            char quote = p[1];
+            const char* name = p + 2;
+            const char* close = strchr(name, quote);
+            if( close == NULL || close[1] != ']' )
+            {
+                lr_error_message("y_json: Unterminated member name in path %s", path);
+                return 0;
+            }
+            segment->type = Y_JSON_SEGMENT_MEMBER;
+            segment->name = y_strview_make(name, close - name);
+            p = close + 2;
+        }
+        else if( *p == '[' && p[1] == '*' && p[2] == ']' )
+        {
+            segment->type = Y_JSON_SEGMENT_WILDCARD;
+            p += 3;
+        }
+        else if( *p == '[' && isdigit(p[1]) )
+        {
+            char* close;
+            segment->type = Y_JSON_SEGMENT_INDEX;
+            segment->index = strtol(p + 1, &close, 10);
+            if( *close != ']' )
+            {
+                lr_error_message("y_json: Invalid array index in path %s", path);
+                return 0;
+            }
+            p = close + 1;
+        }
+        else
+        {
+            lr_error_message("y_json: Invalid path %s at \"%s\"", path, p);
+            return 0;
+        }
+        result->depth++;
+    }
+    return 1;
+}
+
+int y_json_is_whitespace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+void y_json_skip_whitespace(y_json_scanner* s)
+{
+    while( s->pos < s->end && y_json_is_whitespace(*s->pos) )
+        s->pos++;
+}
+
+// Skip a string. s->pos points at the opening quote. Returns non-zero if the string contains escape sequences.
+int y_json_skip_string(y_json_scanner* s)
+{
+    int escaped = 0;
+
+    s->pos++;
+    for(;;)
+    {
+        const char* quote = (const char*) memchr(s->pos, '"', s->end - s->pos);
+        const char* backslash;
+
+        if( quote == NULL )
+        {
+            s->error = "unterminated string";
+            s->pos = s->end;
+            return escaped;
+        }
+        backslash = (const char*) memchr(s->pos, '\\', quote - s->pos);
+        if( backslash == NULL )
+        {
+            s->pos = quote + 1;
+            return escaped;
+        }
+        escaped = 1;
+        s->pos = backslash + 2;
+        if( s->pos > s->end )
+            s->pos = s->end;
+    }
+}
+
+// Skip a value of any type, without looking at what is inside.
+void y_json_skip_value(y_json_scanner* s)
+{
+    int nesting = 0;
+
+    do
+    {
+        const char* start = s->pos;
+
+        if( s->pos >= s->end )
+        {
+            s->error = "unexpected end of document";
+            return;
+        }
+        switch( *s->pos )
+        {
+            case '"':
+                y_json_skip_string(s);
+                break;
+            case '{':
+            case '[':
+                nesting++;
+                s->pos++;
+                break;
+            case '}':
+            case ']':
+                if( --nesting < 0 )
+                {
+                    s->error = "unexpected closing bracket";
+                    return;
+                }
+                s->pos++;
+                break;
+            case ',':
+            case ':':
+            case ' ':
+            case '\t':
+            case '\n':
+            case '\r':
+                if( nesting == 0 )
+                {
+                    s->error = "value expected";
+                    return;
+                }
+                s->pos++;
+                break;
+            default:
+                // Numbers, true, false, null. strchr() also matches the '\0' terminator, so null bytes are checked for separately.
+                while( s->pos < s->end && *s->pos != '\0' && strchr(",:]} \t\r\n\"{[", *s->pos) == NULL )
+                    s->pos++;
+                break;
+        }
+        // Garbage such as null bytes in a binary response: give up rather than loop forever.
+        if( s->pos == start && s->error == NULL )
+            s->error = "unexpected character";
+    }
+    while( nesting > 0 && s->error == NULL );
+}
+
+/*
+Decode a JSON string (without the quotes) into dest. Returns the length of the result.
+dest must have room for at least len bytes; decoded strings are never longer than the original.
+*/
+size_t y_json_unescape(const char* src, size_t len, char* dest)
+{
+    const char* end = src + len;
+    char* out = dest;
+
+    while( src < end )
+    {
+        unsigned int c;
+        int i;
+
+        if( *src != '\\' || src + 1 >= end )
+        {
+            *out++ = *src++;
+            continue;
+        }
+        src++;
+        switch( *src++ )
+        {
+            case 'b': *out++ = '\b'; break;
+            case 'f': *out++ = '\f'; break;
+            case 'n': *out++ = '\n'; break;
+            case 'r': *out++ = '\r'; break;
+            case 't': *out++ = '\t'; break;
+            case 'u':
+                c = 0;
+                for( i = 0; i < 4 && src < end && isxdigit(*src); i++, src++ )
+                    c = c * 16 + (isdigit(*src) ? *src - '0' : (tolower(*src) - 'a' + 10));
+                // Combine surrogate pairs.
+                if( c >= 0xD800 && c <= 0xDBFF && src + 6 <= end && src[0] == '\\' && src[1] == 'u' )
+                {
+                    unsigned int low;
+                    char hex[5];
+                    memcpy(hex, src + 2, 4);
+                    hex[4] = '\0';
+                    low = strtoul(hex, NULL, 16);
+                    if( low >= 0xDC00 && low <= 0xDFFF )
+                    {
+                        c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+                        src += 6;
+                    }
+                }
+                if( c < 0x80 )
+                    *out++ = c;
+                else if( c < 0x800 )
+                {
+                    *out++ = 0xC0 | (c >> 6);
+                    *out++ = 0x80 | (c & 0x3F);
+                }
+                else if( c < 0x10000 )
+                {
+                    *out++ = 0xE0 | (c >> 12);
+                    *out++ = 0x80 | ((c >> 6) & 0x3F);
+                    *out++ = 0x80 | (c & 0x3F);
+                }
+                else
+                {
+                    *out++ = 0xF0 | (c >> 18);
+                    *out++ = 0x80 | ((c >> 12) & 0x3F);
+                    *out++ = 0x80 | ((c >> 6) & 0x3F);
+                    *out++ = 0x80 | (c & 0x3F);
+                }
+                break;
+            default: // \" \\ \/
+                *out++ = src[-1];
+                break;
+        }
+    }
+    return out - dest;
+}
+
+// Save the value between start and end (the raw JSON text) for a path.
+void y_json_save_match(y_json_path* path, const char* start, const char* end)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    const char* name = path->single ? path->result : y_arena_array_element_name(path->result, path->count + 1);
+    const char* value = start;
+    size_t len = end - start;
+
+    if( *start == '"' && len >= 2 )
+    {
+        value = start + 1;
+        len -= 2;
+        if( memchr(value, '\\', len) != NULL )
+        {
+            char* decoded = y_arena_alloc(len + 1);
+            len = y_json_unescape(value, len, decoded);
+            value = decoded;
+        }
+    }
+    lr_save_var(len ? value : "", len, 0, name);
+    y_arena_release(mark);
+
+    path->count++;
+}
+
+// Does a member name, as it appears in the document (without quotes), match a path segment?
+int y_json_member_matches(y_json_segment* segment, const char* name, size_t len, int escaped)
+{
+    if( segment->type == Y_JSON_SEGMENT_WILDCARD )
+        return 1;
+    if( segment->type != Y_JSON_SEGMENT_MEMBER )
+        return 0;
+    if( escaped )
+    {
+        y_arena_mark mark = y_arena_get_mark();
+        char* decoded = y_arena_alloc(len + 1);
+        int result;
+        len = y_json_unescape(name, len, decoded);
+        result = y_strview_equals(y_strview_make(decoded, len), segment->name);
+        y_arena_release(mark);
+        return result;
+    }
+    return y_strview_equals(y_strview_make(name, len), segment->name);
+}
+
+/*
+Walk the value at s->pos, which is at the given depth in the document.
+active has a bit set for each path whose first 'depth' segments match the location of this value.
+*/
+void y_json_walk(y_json_scanner* s, int depth, unsigned int active)
+{
+    const char* start;
+    unsigned int deeper = 0;
+    unsigned int here = 0;
+    int i;
+
+    y_json_skip_whitespace(s);
+    start = s->pos;
+    active &= s->wanted;
+
+    for( i = 0; i < s->path_count; i++ )
+    {
+        if( !(active & (1 << i)) )
+            continue;
+        if( s->paths[i].depth == depth )
+            here |= 1 << i;
+        else
+            deeper |= 1 << i;
+    }
+
+    if( deeper == 0 || s->pos >= s->end || (*s->pos != '{' && *s->pos != '['))
+    {
+        y_json_skip_value(s);
+    }
+    else if( *s->pos == '{' )
+    {
+        s->pos++;
+        y_json_skip_whitespace(s);
+        if( s->pos < s->end && *s->pos == '}' )
+            s->pos++;
+        else while( s->error == NULL )
+        {
+            const char* name;
+            size_t name_len;
+            int escaped;
+            unsigned int child = 0;
+
+            y_json_skip_whitespace(s);
+            if( s->pos >= s->end || *s->pos != '"' )
+            {
+                s->error = "member name expected";
+                return;
+            }
+            name = s->pos + 1;
+            escaped = y_json_skip_string(s);
+            name_len = s->pos - name - 1;
+            y_json_skip_whitespace(s);
+            if( s->pos >= s->end || *s->pos != ':' )
+            {
+                s->error = "':' expected";
+                return;
+            }
+            s->pos++;
+
+            for( i = 0; i < s->path_count; i++ )
+            {
+                if( (deeper & (1 << i)) && y_json_member_matches(&s->paths[i].segments[depth], name, name_len, escaped) )
+                    child |= 1 << i;
+            }
+            if( child )
+            {
+                y_json_walk(s, depth + 1, child);
+                // Everything has been found, so stop without looking for the ',' or closing bracket.
+                if( s->error == NULL && s->wanted == 0 )
+                    s->stopped = 1;
+                if( s->stopped )
+                    return;
+            }
+            else
+            {
+                y_json_skip_whitespace(s);
+                y_json_skip_value(s);
+            }
+
+            y_json_skip_whitespace(s);
+            if( s->pos < s->end && *s->pos == ',' )
+                s->pos++;
+            else if( s->pos < s->end && *s->pos == '}' )
+            {
+                s->pos++;
+                break;
+            }
+            else if( s->error == NULL )
+                s->error = "',' or '}' expected";
+        }
+    }
+    else // '['
+    {
+        int index = 0;
+
+        s->pos++;
+        y_json_skip_whitespace(s);
+        if( s->pos < s->end && *s->pos == ']' )
+            s->pos++;
+        else while( s->error == NULL )
+        {
+            unsigned int child = 0;
+
+            for( i = 0; i < s->path_count; i++ )
+            {
+                y_json_segment* segment = &s->paths[i].segments[depth];
+                if( (deeper & (1 << i)) && (segment->type == Y_JSON_SEGMENT_WILDCARD || (segment->type == Y_JSON_SEGMENT_INDEX && segment->index == index)) )
+                    child |= 1 << i;
+            }
+            if( child )
+            {
+                y_json_walk(s, depth + 1, child);
+                // Everything has been found, so stop without looking for the ',' or closing bracket.
+                if( s->error == NULL && s->wanted == 0 )
+                    s->stopped = 1;
+                if( s->stopped )
+                    return;
+            }
+            else
+            {
+                y_json_skip_whitespace(s);
+                y_json_skip_value(s);
+            }
+            index++;
+
+            y_json_skip_whitespace(s);
+            if( s->pos < s->end && *s->pos == ',' )
+                s->pos++;
+            else if( s->pos < s->end && *s->pos == ']' )
+            {
+                s->pos++;
+                break;
+            }
+            else if( s->error == NULL )
+                s->error = "',' or ']' expected";
+        }
+    }
+
+    if( s->error != NULL )
+        return;
+
+    // A path may have stopped being wanted while walking the children, so check 'here' against wanted again.
+    here &= s->wanted;
+    for( i = 0; i < s->path_count; i++ )
+    {
+        if( here & (1 << i) )
+        {
+            y_json_save_match(&s->paths[i], start, s->pos);
+            if( s->paths[i].single )
+                s->wanted &= ~(1 << i);
+        }
+    }
+}
+
+// Match a number of parsed paths against a parameter in a single pass. Returns 0 if the document is invalid.
+int y_json_scan(const char* function_name, const char* source_param, y_json_path* paths, int path_count)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview document = y_get_parameter_view(source_param);
+    y_json_scanner scanner;
+    int i;
+
+    if( document.ptr == NULL )
+    {
+        lr_error_message("%s(): Error: Parameter %s does not exist!", function_name, source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    memset(&scanner, 0, sizeof(y_json_scanner));
+    scanner.pos = scanner.start = document.ptr;
+    scanner.end = document.ptr + document.len;
+    scanner.paths = paths;
+    scanner.path_count = path_count;
+    scanner.wanted = path_count >= 32 ? 0xFFFFFFFFu : (1u << path_count) - 1;
+
+    y_json_walk(&scanner, 0, scanner.wanted);
+    if( scanner.error == NULL && !scanner.stopped )
+    {
+        y_json_skip_whitespace(&scanner);
+        if( scanner.pos < scanner.end )
+            scanner.error = "unexpected data after the document";
+    }
+    else if( scanner.error == NULL )
+    {
+        // The rest of the document was not read. At least check that it ends the way it started.
+        const char* first = scanner.start;
+        const char* last = scanner.end;
+
+        while( first < last && y_json_is_whitespace(*first) )
+            first++;
+        while( last > first && y_json_is_whitespace(last[-1]) )
+            last--;
+        if( last == first || last[-1] != (*first == '{' ? '}' : ']') )
+        {
+            scanner.pos = last;
+            scanner.error = "document does not end with a closing bracket";
+        }
+    }
+
+    // Always save the counts, so that the arrays stay consistent with the elements written so far.
+    for( i = 0; i < path_count; i++ )
+    {
+        if( !paths[i].single )
+            y_array_save_count(paths[i].count, paths[i].result);
+    }
+    y_arena_release(mark);
+
+    if( scanner.error != NULL )
+    {
+        lr_error_message("%s(): Invalid JSON in parameter %s at offset %d: %s", function_name, source_param, scanner.pos - scanner.start, scanner.error);
+        return 0;
+    }
+    return 1;
+}
+//! \endcond
+
+
+/*!
+\brief Save all values at a JSON path into a parameter array.
+
+The document is walked once, without building a tree. See y_json.c for the supported path syntax and how values are saved.
+
+\param [in] source_param The parameter containing the JSON document.
+\param [in] path The path to the values, for example "$.orders[*].id".
+\param [in] result_array The name of the parameter array to save the values in, using the same {name_N} and {name_count} conventions as y_array_save().
+\returns The number of values found, or -1 if the document is not valid JSON. An invalid path logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("{\"orders\":[{\"id\":1},{\"id\":2}]}", "Body");
+y_json_get("Body", "$.orders[*].id", "OrderId");    // {OrderId_1} is "1", {OrderId_2} is "2", {OrderId_count} is 2
+\endcode
+\sa y_json_get_value(), y_json_get_multi(), y_array_save_param_list()
+*/
+int y_json_get(const char* source_param, const char* path, const char* result_array)
+{
+    y_json_path* parsed = (y_json_path*) y_mem_alloc(sizeof(y_json_path));
+    int result = -1;
+
+    if( !y_json_parse_path(path, parsed) )
+    {
+        free(parsed);
+        lr_abort();
+        return -1;
+    }
+    parsed->result = result_array;
+    parsed->single = 0;
+    if( y_json_scan("y_json_get", source_param, parsed, 1) )
+        result = parsed->count;
+    free(parsed);
+    return result;
+}
+
+/*!
+\brief Save the first value at a JSON path into a parameter.
+
+The scan stops as soon as the value has been found. The rest of the document is then not validated, other than checking that it ends with the closing bracket.
+
+\param [in] source_param The parameter containing the JSON document.
+\param [in] path The path to the value, for example "$.customer.name".
+\param [in] result_param The name of the parameter to save the value in. If there is no such value, it is not touched.
+\returns 1 if the value was found, 0 if it was not, or -1 if the document is not valid JSON.
+\sa y_json_get(), y_json_get_multi()
+*/
+int y_json_get_value(const char* source_param, const char* path, const char* result_param)
+{
+    y_json_path* parsed = (y_json_path*) y_mem_alloc(sizeof(y_json_path));
+    int result = -1;
+
+    if( !y_json_parse_path(path, parsed) )
+    {
+        free(parsed);
+        lr_abort();
+        return -1;
+    }
+    parsed->result = result_param;
+    parsed->single = 1;
+    if( y_json_scan("y_json_get_value", source_param, parsed, 1) )
+        result = parsed->count;
+    free(parsed);
+    return result;
+}
+
+/*!
+\brief Save the values at several JSON paths into parameter arrays, in a single pass over the document.
+
+Extracting ten fields from a large response this way costs one scan instead of ten.
+
+\param [in] source_param The parameter containing the JSON document.
+\param [in] paths The paths. See y_json.c for the syntax.
+\param [in] result_arrays For each path, the name of the parameter array to save the values in.
+\param [in] path_count The number of paths, at most Y_JSON_MAX_PATHS.
+\returns The total number of values found, or -1 if the document is not valid JSON. An invalid path logs an error and calls lr_abort().
+
+\b Example:
+\code
+char* paths[] = { "$.orders[*].id", "$.orders[*].status", "$.customer.name" };
+char* arrays[] = { "OrderId", "OrderStatus", "CustomerName" };
+y_json_get_multi("Body", paths, arrays, 3);
+\endcode
+\sa y_json_get()
+*/
+int y_json_get_multi(const char* source_param, char** paths, char** result_arrays, int path_count)
+{
+    y_json_path* parsed;
+    int i, total = -1;
+
+    if( path_count < 0 || path_count > Y_JSON_MAX_PATHS )
+    {
+        lr_error_message("y_json_get_multi(): Cannot match %d paths in one pass, the maximum is %d.", path_count, Y_JSON_MAX_PATHS);
+        lr_abort();
+        return -1;
+    }
+
+    parsed = (y_json_path*) y_array_alloc(path_count + 1, sizeof(y_json_path));
+    for( i = 0; i < path_count; i++ )
+    {
+        if( !y_json_parse_path(paths[i], &parsed[i]) )
+        {
+            free(parsed);
+            lr_abort();
+            return -1;
+        }
+        parsed[i].result = result_arrays[i];
+    }
+
+    if( y_json_scan("y_json_get_multi", source_param, parsed, path_count) )
+    {
+        total = 0;
+        for( i = 0; i < path_count; i++ )
+            total += parsed[i].count;
+    }
+    free(parsed);
+    return total;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Writing JSON
+// ---------------------------------------------------------------------------------------------------------------------------
+
+//! \brief The maximum nesting depth of objects and arrays for a y_json_writer.
+#define Y_JSON_WRITER_MAX_DEPTH 64
+
+/*!
+\brief Builds a JSON document piece by piece, with correct escaping and punctuation.
+
+Values are appended to a y_strbuf, so building a document of N bytes costs O(N) no matter how many pieces it is made of.
+Commas, colons and quotes are added by the writer. Nesting mistakes, such as a value in an object without a key, log an error and call lr_abort().
+
+\b Example:
+\code
+y_json_writer w;
+y_json_writer_init(&w);
+y_json_writer_begin_object(&w);
+    y_json_writer_key(&w, "customer");
+    y_json_writer_param_string(&w, "CustomerName");
+    y_json_writer_key(&w, "express");
+    y_json_writer_bool(&w, 1);
+    y_json_writer_key(&w, "skus");
+    y_json_writer_param_array(&w, "SKU");
+y_json_writer_end_object(&w);
+y_json_writer_save(&w, "RequestBody");   // {"customer":"Jan","express":true,"skus":["A","B","C"]}
+y_json_writer_free(&w);
+\endcode
+\sa y_json_writer_init(), y_strbuf
+*/
+struct y_struct_json_writer
+{
+    //! The document so far.
+    y_strbuf buf;
+    //! The current nesting depth.
+    int depth;
+    //! For each nesting level, '{' or '['.
+    char container[Y_JSON_WRITER_MAX_DEPTH];
+    //! For each nesting level, the number of values (or keys) written so far.
+    int count[Y_JSON_WRITER_MAX_DEPTH];
+    //! Non-zero if a key has been written and the value for it has not.
+    int after_key;
+    //! Scratch space for building parameter names.
+    y_strbuf scratch;
+};
+//! \brief Builds a JSON document piece by piece. \sa y_struct_json_writer
+typedef struct y_struct_json_writer y_json_writer;
+
+/*!
+\brief Initialize a JSON writer.
+\param [out] w The writer.
+\sa y_json_writer_free()
+*/
+void y_json_writer_init(y_json_writer* w)
+{
+    memset(w, 0, sizeof(y_json_writer));
+    y_strbuf_init(&w->buf, 0);
+    y_strbuf_init(&w->scratch, 0);
+}
+
+/*!
+\brief Free the memory held by a JSON writer.
+\param [in] w The writer.
+*/
+void y_json_writer_free(y_json_writer* w)
+{
+    y_strbuf_free(&w->buf);
+    y_strbuf_free(&w->scratch);
+}
+
+//! \cond internal_functions
+void y_json_writer_error(const char* function_name, const char* message)
+{
+    lr_error_message("%s(): %s", function_name, message);
+    lr_abort();
+}
+
+// Check that a value may be written here, and write the comma before it if needed.
+void y_json_writer_prepare_value(y_json_writer* w, const char* function_name)
+{
+    if( w->depth == 0 )
+    {
+        if( w->buf.len > 0 )
+            y_json_writer_error(function_name, "A JSON document can only have one top level value.");
+        return;
+    }
+    if( w->container[w->depth -1] == '{' )
+    {
+        if( !w->after_key )
+            y_json_writer_error(function_name, "Values in an object need a key. Call y_json_writer_key() first.");
+        w->after_key = 0;
+        return;
+    }
+    if( w->count[w->depth -1]++ > 0 )
+        y_strbuf_append_bytes(&w->buf, ",", 1);
+}
+
+void y_json_writer_append_escaped(y_strbuf* buf, const char* str, size_t len)
+{
+    const char* end = str + len;
+    const char* run = str;
+
+    y_strbuf_reserve(buf, len +2);
+    y_strbuf_append_bytes(buf, "\"", 1);
+    while( str < end )
+    {
+        unsigned char c = *str;
+        if( c >= 0x20 && c != '"' && c != '\\' )
+        {
+            str++;
+            continue;
+        }
+        y_strbuf_append_bytes(buf, run, str - run);
+        switch( c )
+        {
+            case '"':  y_strbuf_append_bytes(buf, "\\\"", 2); break;
+            case '\\': y_strbuf_append_bytes(buf, "\\\\", 2); break;
+            case '\n': y_strbuf_append_bytes(buf, "\\n", 2); break;
+            case '\r': y_strbuf_append_bytes(buf, "\\r", 2); break;
+            case '\t': y_strbuf_append_bytes(buf, "\\t", 2); break;
+            case '\b': y_strbuf_append_bytes(buf, "\\b", 2); break;
+            case '\f': y_strbuf_append_bytes(buf, "\\f", 2); break;
+            default:   y_strbuf_appendf(buf, "\\u%04x", c); break;
+        }
+        run = ++str;
+    }
+    y_strbuf_append_bytes(buf, run, str - run);
+    y_strbuf_append_bytes(buf, "\"", 1);
+}
+
+// Evaluate a parameter into a buffer from lr_eval_string_ext(), without going through the interned parameter table.
+// Returns 0 if the parameter does not exist. The caller frees *content with lr_eval_string_ext_free().
+int y_json_writer_eval(y_json_writer* w, const char* param_name, char** content, unsigned long* len)
+{
+    y_strbuf_reset(&w->scratch);
+    y_strbuf_append_bytes(&w->scratch, "{", 1);
+    y_strbuf_append(&w->scratch, param_name);
+    y_strbuf_append_bytes(&w->scratch, "}", 1);
+
+    lr_eval_string_ext(w->scratch.data, w->scratch.len, content, len, 0, 0, -1);
+    if( *len == w->scratch.len && memcmp(*content, w->scratch.data, *len) == 0 )
+    {
+        lr_eval_string_ext_free(content);
+        return 0;
+    }
+    return 1;
+}
+//! \endcond
+
+/*!
+\brief Start an object.
+\param [in] w The writer.
+\sa y_json_writer_end_object()
+*/
+void y_json_writer_begin_object(y_json_writer* w)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_begin_object");
+    if( w->depth >= Y_JSON_WRITER_MAX_DEPTH )
+    {
+        y_json_writer_error("y_json_writer_begin_object", "Nesting too deep.");
+        return;
+    }
+    w->container[w->depth] = '{';
+    w->count[w->depth] = 0;
+    w->depth++;
+    y_strbuf_append_bytes(&w->buf, "{", 1);
+}
+
+/*!
+\brief End the current object.
+\param [in] w The writer.
+*/
+void y_json_writer_end_object(y_json_writer* w)
+{
+    if( w->depth == 0 || w->container[w->depth -1] != '{' || w->after_key )
+    {
+        y_json_writer_error("y_json_writer_end_object", "Not in an object, or the last key has no value.");
+        return;
+    }
+    w->depth--;
+    y_strbuf_append_bytes(&w->buf, "}", 1);
+}
+
+/*!
+\brief Start an array.
+\param [in] w The writer.
+\sa y_json_writer_end_array()
+*/
+void y_json_writer_begin_array(y_json_writer* w)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_begin_array");
+    if( w->depth >= Y_JSON_WRITER_MAX_DEPTH )
+    {
+        y_json_writer_error("y_json_writer_begin_array", "Nesting too deep.");
+        return;
+    }
+    w->container[w->depth] = '[';
+    w->count[w->depth] = 0;
+    w->depth++;
+    y_strbuf_append_bytes(&w->buf, "[", 1);
+}
+
+/*!
+\brief End the current array.
+\param [in] w The writer.
+*/
+void y_json_writer_end_array(y_json_writer* w)
+{
+    if( w->depth == 0 || w->container[w->depth -1] != '[' )
+    {
+        y_json_writer_error("y_json_writer_end_array", "Not in an array.");
+        return;
+    }
+    w->depth--;
+    y_strbuf_append_bytes(&w->buf, "]", 1);
+}
+
+/*!
+\brief Write the key of the next member of the current object.
+\param [in] w The writer.
+\param [in] key The key. Escaped as needed.
+*/
+void y_json_writer_key(y_json_writer* w, const char* key)
+{
+    if( w->depth == 0 || w->container[w->depth -1] != '{' || w->after_key )
+    {
+        y_json_writer_error("y_json_writer_key", "Keys can only be written in an object, once per value.");
+        return;
+    }
+    if( w->count[w->depth -1]++ > 0 )
+        y_strbuf_append_bytes(&w->buf, ",", 1);
+    y_json_writer_append_escaped(&w->buf, key, strlen(key));
+    y_strbuf_append_bytes(&w->buf, ":", 1);
+    w->after_key = 1;
+}
+
+/*!
+\brief Write a string value.
+\param [in] w The writer.
+\param [in] value The string. Escaped as needed.
+*/
+void y_json_writer_string(y_json_writer* w, const char* value)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_string");
+    y_json_writer_append_escaped(&w->buf, value, strlen(value));
+}
+
+/*!
+\brief Write a string value from a view. Binary safe: null bytes are written as \\u0000.
+\param [in] w The writer.
+\param [in] value The string. Escaped as needed.
+*/
+void y_json_writer_view(y_json_writer* w, y_strview value)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_view");
+    y_json_writer_append_escaped(&w->buf, value.ptr, value.len);
+}
+
+/*!
+\brief Write an integer value.
+\param [in] w The writer.
+\param [in] value The number.
+*/
+void y_json_writer_int(y_json_writer* w, int value)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_int");
+    y_strbuf_appendf(&w->buf, "%d", value);
+}
+
+/*!
+\brief Write a floating point value. JSON has no representation for infinity and NaN, so those are written as null.
+
+The value is written with 17 significant digits, so that reading it back gives exactly the same double.
+\param [in] w The writer.
+\param [in] value The number.
+*/
+void y_json_writer_double(y_json_writer* w, double value)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_double");
+    if( value != value || value - value != 0 )
+        y_strbuf_append_bytes(&w->buf, "null", 4);
+    else
+        y_strbuf_appendf(&w->buf, "%.17g", value);
+}
+
+/*!
+\brief Write a boolean value.
+\param [in] w The writer.
+\param [in] value Zero for false, anything else for true.
+*/
+void y_json_writer_bool(y_json_writer* w, int value)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_bool");
+    if( value )
+        y_strbuf_append_bytes(&w->buf, "true", 4);
+    else
+        y_strbuf_append_bytes(&w->buf, "false", 5);
+}
+
+/*!
+\brief Write a null value.
+\param [in] w The writer.
+*/
+void y_json_writer_null(y_json_writer* w)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_null");
+    y_strbuf_append_bytes(&w->buf, "null", 4);
+}
+
+/*!
+\brief Write a piece of JSON text as a value, as is.
+\param [in] w The writer.
+\param [in] json The value, which must be valid JSON. It is not checked or escaped.
+*/
+void y_json_writer_raw(y_json_writer* w, const char* json)
+{
+    y_json_writer_prepare_value(w, "y_json_writer_raw");
+    y_strbuf_append(&w->buf, json);
+}
+
+/*!
+\brief Write the content of a parameter as a string value.
+\param [in] w The writer.
+\param [in] param_name The name of the parameter. If it does not exist, this logs an error and calls lr_abort().
+*/
+void y_json_writer_param_string(y_json_writer* w, const char* param_name)
+{
+    char* content;
+    unsigned long len;
+
+    y_json_writer_prepare_value(w, "y_json_writer_param_string");
+    if( !y_json_writer_eval(w, param_name, &content, &len) )
+    {
+        lr_error_message("y_json_writer_param_string(): Parameter %s does not exist!", param_name);
+        lr_abort();
+        return;
+    }
+    y_json_writer_append_escaped(&w->buf, content, len);
+    lr_eval_string_ext_free(&content);
+}
+
+/*!
+\brief Write the content of a parameter as a value, as is.
+
+Useful for numbers and for JSON fragments saved from earlier responses, for example with y_json_get().
+\param [in] w The writer.
+\param [in] param_name The name of the parameter, which must contain valid JSON. If it does not exist, this logs an error and calls lr_abort().
+*/
+void y_json_writer_param_raw(y_json_writer* w, const char* param_name)
+{
+    char* content;
+    unsigned long len;
+
+    y_json_writer_prepare_value(w, "y_json_writer_param_raw");
+    if( !y_json_writer_eval(w, param_name, &content, &len) )
+    {
+        lr_error_message("y_json_writer_param_raw(): Parameter %s does not exist!", param_name);
+        lr_abort();
+        return;
+    }
+    y_strbuf_append_bytes(&w->buf, content, len);
+    lr_eval_string_ext_free(&content);
+}
+
+/*!
+\brief Write all elements of a parameter array as an array of strings.
+
+Each element is evaluated once, straight into the document, without creating intermediate parameters.
+\param [in] w The writer.
+\param [in] param_array The name of the parameter array.
+\sa y_json_array_from_param_array()
+*/
+void y_json_writer_param_array(y_json_writer* w, const char* param_array)
+{
+    int size = y_array_count(param_array);
+    int i;
+
+    y_json_writer_begin_array(w);
+    for( i = 1; i <= size; i++ )
+    {
+        char* content;
+        unsigned long len;
+        y_arena_mark mark = y_arena_get_mark();
+
+        if( w->count[w->depth -1]++ > 0 )
+            y_strbuf_append_bytes(&w->buf, ",", 1);
+        if( y_json_writer_eval(w, y_arena_array_element_name(param_array, i), &content, &len) )
+        {
+            y_json_writer_append_escaped(&w->buf, content, len);
+            lr_eval_string_ext_free(&content);
+        }
+        else
+        {
+            y_strbuf_append_bytes(&w->buf, "null", 4);
+        }
+        y_arena_release(mark);
+    }
+    y_json_writer_end_array(w);
+}
+
+/*!
+\brief Save the document into a parameter.
+\param [in] w The writer.
+\param [in] param_name The name of the parameter to save the document in. If the document is not complete, this logs an error and calls lr_abort() without saving anything.
+*/
+void y_json_writer_save(y_json_writer* w, const char* param_name)
+{
+    if( w->depth != 0 || w->after_key )
+    {
+        lr_error_message("y_json_writer_save(): The JSON document is not complete; %d objects or arrays are still open.", w->depth);
+        lr_abort();
+        return;
+    }
+    y_strbuf_save_to_param(&w->buf, param_name);
+}
+
+/*!
+\brief Save all elements of a parameter array into a parameter, as a JSON array of strings.
+\param [in] param_array The name of the parameter array.
+\param [in] result_param The name of the parameter to save the JSON text in.
+
+\b Example:
+\code
+web_reg_save_param("TAG", "LB=<sku>", "RB=</sku>", "ORD=ALL", LAST);
+web_url("products", "URL=http://www.example.com/products", LAST);
+y_json_array_from_param_array("TAG", "TagJson");    // {TagJson} is ["A","B","C"]
+\endcode
+\sa y_json_writer_param_array()
+*/
+void y_json_array_from_param_array(const char* param_array, const char* result_param)
+{
+    y_json_writer w;
+    y_json_writer_init(&w);
+    y_json_writer_param_array(&w, param_array);
+    y_json_writer_save(&w, result_param);
+    y_json_writer_free(&w);
+}
+
+#endif // _Y_JSON_C_
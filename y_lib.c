@@ -46,6 +46,13 @@
 #include "y_logging.c"
 #include "y_transaction.c"
 #include "y_param_array.c"
+#include "y_regex.c"
+#include "y_json.c"
+#include "y_xml.c"
+#include "y_template.c"
+#include "y_codec.c"
+#include "y_html.c"
+#include "y_csv.c"
 #include "y_flow_list.c" // y_profile.c got renamed, and most variables and function names in there as well.
 #include "y_browseremulation.c"
 
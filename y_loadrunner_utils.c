@@ -43,6 +43,7 @@ If we don't have somewhere else to put some piece of code, this is where it will
 //! \endcond
 
 #include "y_core.c"
+#include "y_string.c"
 
 //! \cond function_removal
 #define _vUserID 0_vUserID_no_longer_exists_please_use_y_virtual_user_id_or_function_y_is_vugen_run
@@ -263,6 +264,11 @@ void y_log_rendezvous_result(int result)
 // --------------------------------------------------------------------------------------------------
 
 
+//! \cond internal_global
+//! INTERNAL: The breadcrumb built so far. \see y_breadcrumb()
+y_strbuf _y_breadcrumb = {NULL, 0, 0};
+//! \endcond
+
 //! Keep track of the steps in the script
 /*!
 Adds (another) string (read: step) to the LR-parameter {breadcrumb}
@@ -283,6 +289,8 @@ y_breadcrumb("processing data")
 y_breadcrumb("finished")
 The result is that {breadcrumb} contains "start;processing data;finished"   
 \endcode
+\note The breadcrumb is built in memory with a y_strbuf, and {breadcrumb} receives a copy after every step.
+Changes made to {breadcrumb} directly are only noticed if they change its length, such as saving an empty string into it. Use y_breadcrumb_reset() instead.
 \sa y_breadcrumb_reset()
 \author Raymond de Jongh
 */
@@ -290,27 +298,48 @@ void y_breadcrumb(char *breadcrumb)
 {
     lr_message("---------------------------------------------------------------------------------");
 
-    if( y_is_empty_parameter("breadcrumb") || ((strlen(breadcrumb) == 0)) )
+    if( (strlen(breadcrumb) == 0) )
     {
-        lr_save_string(breadcrumb, "breadcrumb");
+        y_strbuf_reset(&_y_breadcrumb);
     }
     else
     {
-        lr_param_sprintf("breadcrumb", "%s;%s", lr_eval_string("{breadcrumb}"), breadcrumb);
+        // _y_breadcrumb is leading and {breadcrumb} only ever receives copies of it.
+        // A different length means {breadcrumb} was changed directly since the last step, for instance by saving an empty string into it.
+        y_arena_mark mark = y_arena_get_mark();
+        y_strview current = y_get_parameter_view("breadcrumb");
+
+        if( current.ptr == NULL || current.len != _y_breadcrumb.len )
+        {
+            y_strbuf_reset(&_y_breadcrumb);
+            if( current.ptr != NULL )
+                y_strbuf_append_view(&_y_breadcrumb, current);
+        }
+        y_arena_release(mark);
+
+        if( _y_breadcrumb.len > 0 )
+        {
+            y_strbuf_append(&_y_breadcrumb, ";");
+        }
+        y_strbuf_append(&_y_breadcrumb, breadcrumb);
     }
+    y_strbuf_save_to_param(&_y_breadcrumb, "breadcrumb");
 }
 
 // --------------------------------------------------------------------------------------------------
 
 
 /*!
-\def y_breadcrumb_reset()
 \brief Resets the breadcrumb 
-Use this macro to start a new breadcrumb or to reset an existing one.
+Use this function to start a new breadcrumb or to reset an existing one.
 \author Raymond de Jongh
 \sa y_breadcrumb()
 */
-#define y_breadcrumb_reset() lr_save_string("", "breadcrumb")
+void y_breadcrumb_reset()
+{
+    y_strbuf_reset(&_y_breadcrumb);
+    lr_save_string("", "breadcrumb");
+}
 
 
 // --------------------------------------------------------------------------------------------------
@@ -384,13 +413,15 @@ int y_write_parameter_to_file(char *filename, char *content_parameter)
     unsigned long nLength;
     int result = 0;
     int tmp = 0;
+    y_arena_mark mark;
 
     lr_log_message("y_write_parameter_to_file(\"%s\", \"%s\")", filename, content_parameter);
     
     // Get the parameter content. Tricky because of the possibility of embedded null bytes in there.
-	param = y_get_parameter_eval_string(content_parameter);
+	mark = y_arena_get_mark();
+	param = y_arena_get_parameter_eval_string(content_parameter);
     lr_eval_string_ext(param, strlen(param), &szBuf, &nLength, 0, 0, -1);
-	free(param);
+	y_arena_release(mark);
 
     // Open the file.
     if( !(fp = fopen(filename, "wb")) ) 
@@ -671,6 +702,7 @@ projectname_some_request_transaction()
    y_end_transaction("", LR_AUTO);
 }
 \endcode
+\sa y_template_compile()
 \author Floris Kraak
 */
 int y_read_file_into_parameter(char* filename, char* param)
@@ -1010,6 +1042,7 @@ implement closely related functionality. If you use this please think carefully
 with each other.
 
 \note This will create a user datapoint called y_pacing_time that can be used for monitoring the calculations during the test.
+\note Since this marks the start of a new iteration, this also resets the y-lib arena. See y_arena_reset().
 
 \b Example:
 \code
@@ -1035,6 +1068,9 @@ double y_pace(double pacing_time_in_seconds)
 	static double total_pacing_time = 0;             // Running total of requested pacing time.
 	double current_time = y_get_current_time();      // Current time, in seconds since 1 jan 1970.
 
+	// New iteration: any arena memory left over from the previous one can go.
+	y_arena_reset();
+
 	// Initialisation.
 	// On the first call we store the current time as the test start time and the end time of the previous call.
 	if( test_start_time < 1 )
@@ -1113,6 +1149,7 @@ This will force an extra pacing of 5 minutes after 10 successive failed iteratio
 
 \note The forced pause ignores runtime thinktime settings.
 \note This will call y_pace() using the enforced pausing time to make sure it's internal administration doesn't get confused.
+\note y_errorcheck(0) resets the y-lib arena, as it marks the start of a new iteration. See y_arena_reset().
 
 \param [in] ok Start/end iteration marker. Must be set to 0 at the start of the iteration, and 1 at the end of the iteration.
 \author Andr Luyer, Floris Kraak
@@ -1151,6 +1188,7 @@ int y_errorcheck(int ok)
 		               enabled ? "": " 0", pacing_limit, abort_limit, pause_time / 60, pause_time % 60);
     }
     
+    if (!ok) y_arena_reset(); // start of a new iteration
     if (!enabled) return 0;
     
     if (ok) errorcount = 0;
@@ -56,6 +56,22 @@ If you still use loadrunner versions earlier than 9 you may need to add the line
 int _y_random_array_index = 0;
 
 
+/*! \brief Build the name of a parameter array element in arena memory.
+
+\param [in] param_array The name of the parameter array.
+\param [in] index The index of the element.
+\returns The element name ("param_array_index"), allocated with y_arena_alloc().
+
+\see y_arena_alloc(), y_array_save()
+*/
+char* y_arena_array_element_name(const char* param_array, const int index)
+{
+    size_t size = strlen(param_array) +13; // 13 = '_' + up to 11 characters for the index + '\0'
+    char *result = y_arena_alloc(size);
+    snprintf(result, size, "%s_%d", param_array, index);
+    return result;
+}
+
 /*! \def y_array_count
 \brief Determine the number of elements in the target parameter array.
 \param [in] param_array The name of the parameter array.
@@ -79,12 +95,13 @@ If Y_COMPAT_LR_8 is not defined this function is replaced with a simple macro ca
 int y_array_count( const char *param_array )
 {
     int result;
+    y_arena_mark mark = y_arena_get_mark();
     size_t size = strlen(param_array) +9; // 9 = strlen("{}_count") +1 -- the +1 is '\0'
-    char *tmp = y_mem_alloc(size);
+    char *tmp = y_arena_alloc(size);
 
     snprintf(tmp , size, "{%s_count}" , param_array );
     result = atoi(lr_eval_string(tmp));
-    free(tmp);
+    y_arena_release(mark);
     return result;
 }
 #else
@@ -119,6 +136,7 @@ If Y_COMPAT_LR_8 is not defined this function is replaced with a simple macro ca
 char *y_array_get( const char *source_param_array, const int param_array_index )
 {
     int size = y_array_count( source_param_array );
+    y_arena_mark mark;
     char *tmp;
     char *result;
 
@@ -131,14 +149,15 @@ char *y_array_get( const char *source_param_array, const int param_array_index )
     }
 
     // Calculate space requirements
+    mark = y_arena_get_mark();
     {
         size_t bufsize = strlen(source_param_array)+y_int_strlen(param_array_index)+4; // strlen() + size of index + {}_\0
-        tmp = y_mem_alloc(bufsize); 
+        tmp = y_arena_alloc(bufsize); 
         snprintf( tmp , bufsize, "{%s_%d}" , source_param_array , param_array_index );
     }
 
     result = lr_eval_string(tmp);
-    free (tmp);
+    y_arena_release(mark);
     return result;
 }
 #else
@@ -198,11 +217,10 @@ char* y_array_get_no_zeroes( const char *source_param_array, const int param_arr
     }
     else
     {
-        // Calculate space requirements
-        size_t bufsize = strlen(source_param_array) + y_int_strlen(param_array_index) +2; // strlen() + _\0
-        char* tmp = y_mem_alloc(bufsize);
-        snprintf(tmp, bufsize, "%s_%d", source_param_array, param_array_index );
-        return y_get_cleansed_parameter(tmp, ' '); // <-- Might want to make that configurable..
+        y_arena_mark mark = y_arena_get_mark();
+        char* result = y_get_cleansed_parameter(y_arena_array_element_name(source_param_array, param_array_index), ' '); // <-- Might want to make that configurable..
+        y_arena_release(mark);
+        return result;
     }
 }
 
@@ -235,11 +253,9 @@ void y_array_save(const char* value, const char* source_param_array, const int p
     }
     else
     {
-        int len = strlen(source_param_array) + y_int_strlen(param_array_index) +2; // +2 = _\0
-        char *result = y_mem_alloc(len);
-        snprintf(result, len, "%s_%d", source_param_array, param_array_index);
-        lr_save_string(value, result);
-        free(result);
+        y_arena_mark mark = y_arena_get_mark();
+        lr_save_string(value, y_arena_array_element_name(source_param_array, param_array_index));
+        y_arena_release(mark);
     }
 }
 
@@ -264,12 +280,13 @@ void y_array_save_count(const int count, const char *source_param_array)
     }
     else 
     {
+        y_arena_mark mark = y_arena_get_mark();
         int len = strlen(source_param_array) +7; // 7 = strlen("_count") +1, where +1 would be the '\0' byte at the end.
-        char* result = y_mem_alloc(len);
+        char* result = y_arena_alloc(len);
 
         snprintf(result, len, "%s_count", source_param_array);
         lr_save_int(count, result);
-        free(result);
+        y_arena_release(mark);
     }
 }
 
@@ -466,27 +483,492 @@ y_array_dump("VALUES");    // {VALUES_1} contains "water" (no quotes)    {VALUES
 void y_array_save_param_list(const char *sourceParam, const char *LB, const char *RB, const char *result_array)
 {
     int i = 0;
-    char *source = y_get_parameter(sourceParam);
-    int buflen = strlen(source)+1;
-    char *buffer = y_mem_alloc(buflen);
-    char *next = buffer;
-    memcpy(buffer, source, buflen);
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview rest = y_get_parameter_view(sourceParam);
+    y_strview left = y_strview_from_string(LB);
+    y_strview right = y_strview_from_string(RB);
+    int pos;
 
-    while( next = (char *)strstr(next, LB) )
+    if( left.len == 0 && right.len == 0 )
     {
-        char* end = strstr(next, RB);
-        if(!end) 
+        lr_error_message("y_array_save_param_list(): Left and right boundaries cannot both be empty!");
+        lr_abort();
+        y_arena_release(mark);
+        return;
+    }
+
+    while( (pos = y_strview_find(rest, left)) >= 0 )
+    {
+        y_arena_mark element_mark;
+        int end;
+
+        rest = y_strview_slice(rest, pos + left.len, rest.len);
+        if( (end = y_strview_find(rest, right)) < 0 )
             break;
-        buffer[end - buffer] = '\0';
 
         i++;
-        y_array_save(next+strlen(LB), result_array, i);
-        next = end + strlen(RB);
+        element_mark = y_arena_get_mark();
+        lr_save_var(rest.ptr, end, 0, y_arena_array_element_name(result_array, i));
+        y_arena_release(element_mark);
+        rest = y_strview_slice(rest, end + right.len, rest.len);
     }
-    free(buffer);
+    y_arena_release(mark);
     y_array_save_count(i, result_array);
 }
 
+//! \brief The size of the chunks y_array_save_param_list_from_file() reads. \sa y_extract_stream_feed()
+#define Y_EXTRACT_STREAM_CHUNK_SIZE 65536
+
+/*! \brief State of a streaming boundary extraction. \sa y_extract_stream_init() */
+struct y_struct_extract_stream
+{
+    //! The left boundary.
+    char* lb;
+    //! The length of the left boundary.
+    size_t lb_len;
+    //! The right boundary.
+    char* rb;
+    //! The length of the right boundary.
+    size_t rb_len;
+    //! The name of the parameter array to save the values in.
+    char* result_array;
+    //! The number of values found so far.
+    int count;
+    //! Non-zero if the left boundary has been found, and the right boundary has not.
+    int in_value;
+    //! Input that has not been consumed yet: a partial boundary, or a partial value.
+    char* buffer;
+    //! The number of bytes in buffer.
+    size_t len;
+    //! The allocated size of buffer.
+    size_t size;
+    //! The offset in buffer where the unconsumed input (or the current value) starts.
+    size_t start;
+    //! The offset in buffer from where to continue searching for a boundary.
+    size_t scanned;
+};
+//! \brief State of a streaming boundary extraction. \sa y_extract_stream_init()
+typedef struct y_struct_extract_stream y_extract_stream;
+
+/*! \brief Start extracting all LB/RB-delimited values from input that arrives in pieces.
+
+This is the streaming version of y_array_save_param_list(): feed the input in chunks of any size with y_extract_stream_feed(),
+then call y_extract_stream_finish(). Values are saved into the result array as soon as their right boundary comes in, and boundaries
+that are split over two chunks are found just the same. Only the part of the input that can still be part of a value or boundary
+is kept in memory, so this can process documents far larger than would fit in a single parameter.
+
+\param [in] LB The left boundary.
+\param [in] RB The right boundary. LB and RB cannot both be empty.
+\param [in] result_array The name of the parameter array to save the values in.
+\returns The extraction state, to be passed to y_extract_stream_feed() and y_extract_stream_finish().
+
+\b Example:
+\code
+y_extract_stream* stream = y_extract_stream_init("<id>", "</id>", "IDS");
+y_extract_stream_feed(stream, "<id>1</id><i", 12);
+y_extract_stream_feed(stream, "d>2</id>", 8);
+y_extract_stream_finish(stream);   // {IDS_1} contains "1", {IDS_2} contains "2", {IDS_count} is 2
+\endcode
+\sa y_array_save_param_list(), y_array_save_param_list_from_file()
+*/
+y_extract_stream* y_extract_stream_init(const char* LB, const char* RB, const char* result_array)
+{
+    y_extract_stream* stream;
+
+    if( LB[0] == '\0' && RB[0] == '\0' )
+    {
+        lr_error_message("y_extract_stream_init(): Left and right boundaries cannot both be empty!");
+        lr_abort();
+        return NULL;
+    }
+
+    stream = (y_extract_stream*) y_array_alloc(1, sizeof(y_extract_stream));
+    stream->lb = y_strdup((char*)LB);
+    stream->lb_len = strlen(LB);
+    stream->rb = y_strdup((char*)RB);
+    stream->rb_len = strlen(RB);
+    stream->result_array = y_strdup((char*)result_array);
+    return stream;
+}
+
+//! \cond internal_functions
+// Find and save as many values as the buffered input allows, then drop whatever can no longer be part of a match.
+void y_extract_stream_scan(y_extract_stream* stream)
+{
+    for(;;)
+    {
+        const char* from = stream->buffer + stream->scanned;
+        size_t avail = stream->len - stream->scanned;
+        const char* hit;
+
+        if( !stream->in_value )
+        {
+            if( (hit = y_find(from, avail, stream->lb, stream->lb_len)) == NULL )
+            {
+                // Keep only what could be the start of a left boundary.
+                if( avail >= stream->lb_len )
+                    stream->start = stream->scanned = stream->len - stream->lb_len +1;
+                return;
+            }
+            stream->start = stream->scanned = hit - stream->buffer + stream->lb_len;
+            stream->in_value = 1;
+        }
+        else
+        {
+            y_arena_mark mark;
+
+            if( (hit = y_find(from, avail, stream->rb, stream->rb_len)) == NULL )
+            {
+                // Keep the value so far, but don't search it for the right boundary again.
+                if( avail >= stream->rb_len )
+                    stream->scanned = stream->len - stream->rb_len +1;
+                return;
+            }
+            mark = y_arena_get_mark();
+            lr_save_var(stream->buffer + stream->start, hit - stream->buffer - stream->start, 0, y_arena_array_element_name(stream->result_array, ++stream->count));
+            y_arena_release(mark);
+            stream->start = stream->scanned = hit - stream->buffer + stream->rb_len;
+            stream->in_value = 0;
+        }
+    }
+}
+//! \endcond
+
+/*! \brief Feed the next chunk of input to a streaming boundary extraction.
+\param [in] stream The extraction state, as returned by y_extract_stream_init().
+\param [in] data The next chunk of input. Does not need to be null terminated, and may contain null bytes.
+\param [in] len The length of data.
+\sa y_extract_stream_init(), y_extract_stream_finish()
+*/
+void y_extract_stream_feed(y_extract_stream* stream, const char* data, size_t len)
+{
+    // Move the unconsumed input to the front of the buffer, then add the new chunk.
+    if( stream->start > 0 )
+    {
+        memmove(stream->buffer, stream->buffer + stream->start, stream->len - stream->start);
+        stream->len -= stream->start;
+        stream->scanned -= stream->start;
+        stream->start = 0;
+    }
+    if( stream->len + len > stream->size )
+    {
+        stream->size = stream->len + len > stream->size * 2 ? stream->len + len : stream->size * 2;
+        stream->buffer = (char*) realloc(stream->buffer, stream->size);
+        if( stream->buffer == NULL )
+        {
+            lr_error_message("Out of memory: cannot allocate %d bytes for y_extract_stream_feed()", stream->size);
+            lr_abort();
+            return;
+        }
+    }
+    memcpy(stream->buffer + stream->len, data, len);
+    stream->len += len;
+
+    y_extract_stream_scan(stream);
+}
+
+/*! \brief Finish a streaming boundary extraction.
+
+Saves the number of values found as the count of the result array and frees the extraction state.
+As with y_array_save_param_list(), a value that has a left boundary but no right boundary at the end of the input is not saved.
+
+\param [in] stream The extraction state, as returned by y_extract_stream_init(). Cannot be used anymore after this call.
+\returns The number of values found.
+\sa y_extract_stream_init(), y_extract_stream_feed()
+*/
+int y_extract_stream_finish(y_extract_stream* stream)
+{
+    int count = stream->count;
+
+    y_array_save_count(count, stream->result_array);
+    free(stream->buffer);
+    free(stream->lb);
+    free(stream->rb);
+    free(stream->result_array);
+    free(stream);
+    return count;
+}
+
+/*! \brief Save all LB/RB-delimited values in a file into a parameter array, without reading the whole file into memory.
+
+As y_array_save_param_list(), but for a file. The file is read in chunks of Y_EXTRACT_STREAM_CHUNK_SIZE bytes, so files of
+hundreds of megabytes can be processed with memory use that depends only on the size of the largest value.
+
+\param [in] filename The name of the file to read (relative to script root, or full path)
+\param [in] LB The left boundary.
+\param [in] RB The right boundary. LB and RB cannot both be empty.
+\param [in] result_array The name of the parameter array to save the values in.
+\returns The number of values found, or -1 if the file cannot be opened or both boundaries are empty. Both also log an error and call lr_abort().
+
+\b Example:
+\code
+y_array_save_param_list_from_file("export.xml", "<customer_id>", "</customer_id>", "CUSTOMERS");
+\endcode
+\sa y_array_save_param_list(), y_extract_stream_init(), y_read_file_into_parameter()
+*/
+int y_array_save_param_list_from_file(const char* filename, const char* LB, const char* RB, const char* result_array)
+{
+    y_extract_stream* stream;
+    char* chunk;
+    long f;
+    int len;
+
+    if( (f = fopen(filename, "rb")) == NULL )
+    {
+        lr_error_message("Unable to open file %s", filename);
+        lr_abort();
+        return -1;
+    }
+
+    stream = y_extract_stream_init(LB, RB, result_array);
+    if( stream == NULL )
+    {
+        fclose(f);
+        return -1;
+    }
+    chunk = y_mem_alloc(Y_EXTRACT_STREAM_CHUNK_SIZE);
+    while( (len = fread(chunk, 1, Y_EXTRACT_STREAM_CHUNK_SIZE, f)) > 0 )
+    {
+        y_extract_stream_feed(stream, chunk, len);
+    }
+    fclose(f);
+    free(chunk);
+    return y_extract_stream_finish(stream);
+}
+
+/*! \brief One field of a y_extract_many() call. \sa y_extract_many_table() */
+struct y_struct_extract_field
+{
+    //! Index of the left boundary in the search strings of the automaton.
+    int left;
+    //! Index of the right boundary in the search strings of the automaton.
+    int right;
+    //! The parameter (or parameter array, for ordinal 0) to save the result in.
+    const char* result;
+    //! Which match to save: 1 for the first, 2 for the second, and so on. 0 saves all of them as a parameter array.
+    int ordinal;
+    //! The number of matches found so far.
+    int count;
+    //! Non-zero while the left boundary has been found and the right boundary is being looked for.
+    int in_value;
+    //! The offset from where the boundary that is being looked for may start.
+    size_t from;
+    //! Non-zero once the requested match has been saved.
+    int done;
+};
+//! \brief One field of a y_extract_many() call. \sa y_struct_extract_field
+typedef struct y_struct_extract_field y_extract_field;
+
+/*! \brief Extract several values from a parameter in one pass, table driven, with an optional ordinal per value.
+
+Every value is defined by a left boundary, a right boundary and a result parameter, like y_substr().
+All boundaries are searched for together with an Aho-Corasick automaton over the set of distinct boundaries, so the parameter is evaluated once
+and scanned once, no matter how many values are extracted. The scan stops as soon as every requested value has been found.
+The automaton is cached, so repeated calls with the same boundaries don't rebuild it.
+
+Each value is found exactly as if it was searched for on it's own: the first left boundary, then the first right boundary after it.
+For the next ordinal the search continues after that right boundary, like web_reg_save_param() does with "ORD=".
+Binary safe.
+
+\param [in] source_param The parameter to search.
+\param [in] left The left boundaries. Must not be empty: an empty boundary logs an error and calls lr_abort().
+\param [in] right The right boundaries. Must not be empty: an empty boundary logs an error and calls lr_abort().
+\param [in] results The names of the parameters to store the results in. Parameters for values that are not found are not touched.
+\param [in] ordinals Which match to save for each value: 1 for the first, 2 for the second, and so on. 0 saves all matches into a parameter array
+(with a _count). NULL means the first match for all values.
+\param [in] field_count The number of values to extract.
+\returns The number of values that were found. For ordinal 0 a value counts as found if there was at least one match.
+
+\b Example:
+\code
+char* left[]    = { "<orderId>", "<status>", "<line>" };
+char* right[]   = { "</orderId>", "</status>", "</line>" };
+char* results[] = { "OrderId", "Status", "Line" };
+int ordinals[]  = { 1, 1, 0 };
+y_extract_many_table("Response", left, right, results, ordinals, 3);   // {OrderId}, {Status}, and {Line_1} .. {Line_count}
+\endcode
+\sa y_extract_many(), y_substr(), y_substr_nth()
+*/
+int y_extract_many_table(const char* source_param, char** left, char** right, char** results, int* ordinals, int field_count)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_get_parameter_view(source_param);
+    y_extract_field* fields = (y_extract_field*) y_arena_alloc(field_count * sizeof(y_extract_field) +1);
+    char** boundaries = (char**) y_arena_alloc(field_count * 2 * sizeof(char*) +1);
+    char** nothing = (char**) y_arena_alloc(field_count * 2 * sizeof(char*) +1);
+    int boundary_count = 0;
+    int remaining = field_count;    // Fields still looking for a single match.
+    int save_all = 0;               // Fields saving all matches. They need the scan to run to the end.
+    int found = 0;
+    y_replace_automaton* ac;
+    const unsigned char* text;
+    size_t pos;
+    int state = 0;
+    int i;
+
+    if( source.ptr == NULL )
+    {
+        lr_error_message("y_extract_many(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    // Collect the distinct boundaries.
+    for( i = 0; i < field_count * 2; i++ )
+    {
+        char* boundary = (i % 2) ? right[i / 2] : left[i / 2];
+        int b;
+
+        if( boundary == NULL || boundary[0] == '\0' )
+        {
+            lr_error_message("y_extract_many(): Error: Empty boundary passed for %s. Both boundaries must be given.", results[i / 2]);
+            lr_abort();
+            y_arena_release(mark);
+            return 0;
+        }
+        for( b = 0; b < boundary_count && strcmp(boundaries[b], boundary) != 0; b++ )
+            ;
+        if( b == boundary_count )
+        {
+            boundaries[boundary_count] = boundary;
+            nothing[boundary_count++] = "";
+        }
+        if( i % 2 )
+            fields[i / 2].right = b;
+        else
+            fields[i / 2].left = b;
+    }
+    for( i = 0; i < field_count; i++ )
+    {
+        fields[i].result = results[i];
+        fields[i].ordinal = ordinals ? ordinals[i] : 1;
+        fields[i].count = 0;
+        fields[i].in_value = 0;
+        fields[i].from = 0;
+        fields[i].done = 0;
+        if( fields[i].ordinal <= 0 )
+        {
+            fields[i].ordinal = 0;
+            remaining--;
+            save_all++;
+        }
+    }
+    ac = y_replace_automaton_get(boundaries, nothing, boundary_count);
+
+    text = (const unsigned char*) source.ptr;
+    for( pos = 0; pos < source.len && (remaining > 0 || save_all > 0); pos++ )
+    {
+        int t;
+
+        state = ac->delta[state * ac->class_count + ac->byte_class[text[pos]]];
+        if( ac->output[state] < 0 )
+            continue;
+
+        // Every boundary that ends here: the one this state spells, and the ones along the dictionary links.
+        t = (ac->search_len[ac->output[state]] == (size_t) ac->depth[state]) ? state : ac->dictionary_link[state];
+        for( ; t != 0; t = ac->dictionary_link[t] )
+        {
+            int b = ac->output[t];
+            size_t end = pos +1;
+            size_t start = end - ac->search_len[b];
+
+            for( i = 0; i < field_count; i++ )
+            {
+                y_extract_field* field = &fields[i];
+                if( field->done || start < field->from )
+                    continue;
+
+                if( !field->in_value && field->left == b )
+                {
+                    field->in_value = 1;
+                    field->from = end;
+                }
+                else if( field->in_value && field->right == b )
+                {
+                    y_strview value = y_strview_make(source.ptr + field->from, start - field->from);
+                    field->count++;
+                    if( field->ordinal == 0 )
+                    {
+                        y_arena_mark element_mark = y_arena_get_mark();
+                        y_save_view(value, y_arena_array_element_name(field->result, field->count));
+                        y_arena_release(element_mark);
+                    }
+                    else if( field->count == field->ordinal )
+                    {
+                        y_save_view(value, field->result);
+                        field->done = 1;
+                        remaining--;
+                        found++;
+                    }
+                    field->in_value = 0;
+                    field->from = end;
+                }
+            }
+        }
+    }
+
+    for( i = 0; i < field_count; i++ )
+    {
+        if( fields[i].ordinal == 0 )
+        {
+            y_array_save_count(fields[i].count, fields[i].result);
+            if( fields[i].count > 0 )
+                found++;
+        }
+    }
+    y_arena_release(mark);
+    return found;
+}
+
+/*! \brief Extract several values from a parameter in one pass.
+
+Takes any number of (left boundary, right boundary, result parameter) triples, and saves the first match for each of them:
+the text between the first left boundary and the first right boundary after it. The parameter is evaluated and scanned only once, and the scan
+stops as soon as every value has been found.
+For ordinals, or saving all matches into a parameter array, use y_extract_many_table().
+
+\note This is not a drop-in replacement for a series of y_substr() calls. Both boundaries must be given; an empty boundary logs an error and calls lr_abort().
+And values that are not found leave their result parameter untouched, where y_substr() would fall back to the start or the end of the parameter.
+
+\param [in] source_param The parameter to search.
+\param [in] field_count The number of triples that follow.
+\param [in] ... field_count times: the left boundary, the right boundary, and the name of the result parameter. The boundaries must not be empty.
+\returns The number of values that were found.
+
+\b Example:
+\code
+y_extract_many("Response", 3,
+               "<orderId>", "</orderId>", "OrderId",
+               "<status>", "</status>", "Status",
+               "name=\"csrf\" value=\"", "\"", "CsrfToken");
+\endcode
+\sa y_extract_many_table(), y_substr()
+*/
+int y_extract_many(const char* source_param, int field_count, ...)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    char** left = (char**) y_arena_alloc(field_count * sizeof(char*) +1);
+    char** right = (char**) y_arena_alloc(field_count * sizeof(char*) +1);
+    char** results = (char**) y_arena_alloc(field_count * sizeof(char*) +1);
+    va_list args;
+    int found;
+    int i;
+
+    va_start(args, field_count);
+    for( i = 0; i < field_count; i++ )
+    {
+        left[i] = va_arg(args, char*);
+        right[i] = va_arg(args, char*);
+        results[i] = va_arg(args, char*);
+    }
+    va_end(args);
+
+    found = y_extract_many_table(source_param, left, right, results, NULL, field_count);
+    y_arena_release(mark);
+    return found;
+}
+
 /*! \brief Search a parameter array for a specific text and build a new array containing only parameters containing that text.
 
 Let's just call it 'grep'. :)
@@ -503,7 +985,7 @@ y_array_grep("VALUES", "r", "VALUES2");   // get all elements containing "r" (cr
 y_array_dump("VALUES2");
 \endcode
 
-\see y_array_filter(), y_array_concat(), y_array_pick_random()
+\see y_array_filter(), y_array_grep_i(), y_array_concat(), y_array_pick_random()
 \author Floris Kraak
 */
 void y_array_grep( const char *source_param_array, const char *search, const char *result_array)
@@ -511,11 +993,49 @@ void y_array_grep( const char *source_param_array, const char *search, const cha
     int i, j = 1;
     char *item;
     int size = y_array_count(source_param_array);
+    size_t search_len = strlen(search);
+
+    for( i=1; i <= size; i++)
+    {
+        item = y_array_get_no_zeroes(source_param_array, i);
+        if( y_find(item, strlen(item), search, search_len) )
+        {
+            y_array_save(item, result_array, j++);
+        }
+        lr_eval_string_ext_free(&item);
+    }
+    y_array_save_count(j-1, result_array);
+}
+
+/*! \brief Search a parameter array for a specific string, ignoring differences in case, and build a new result array containing only parameters containing the string.
+
+Case insensitive version of y_array_grep(). Only the ASCII letters A-Z are folded, while searching; the elements are not copied or converted first.
+
+\param [in] source_param_array The name of the array to be searched.
+\param [in] search The string to search for.
+\param [in] result_array The name of the array to hold the resulting values. Can be the same as the original parameter array.
+
+\b Example:
+\code
+lr_save_string("<Apple><balloon><CRAYON><drum>", "SOURCE");
+y_array_save_param_list("SOURCE", "<", ">", "VALUES");
+y_array_grep_i("VALUES", "r", "VALUES2");   // get all elements containing "r" or "R" (CRAYON and drum)
+y_array_dump("VALUES2");
+\endcode
+
+\see y_array_grep(), y_find_i()
+*/
+void y_array_grep_i( const char *source_param_array, const char *search, const char *result_array)
+{
+    int i, j = 1;
+    char *item;
+    int size = y_array_count(source_param_array);
+    size_t search_len = strlen(search);
 
     for( i=1; i <= size; i++)
     {
         item = y_array_get_no_zeroes(source_param_array, i);
-        if( strstr(item, search) )
+        if( y_find_i(item, strlen(item), search, search_len) )
         {
             y_array_save(item, result_array, j++);
         }
@@ -548,11 +1068,12 @@ void y_array_filter( const char *source_param_array, const char *search, const c
     int i, j = 1;
     char *item;
     int size = y_array_count(source_param_array);
+    size_t search_len = strlen(search);
 
     for( i=1; i <= size; i++)
     {
         item = y_array_get_no_zeroes(source_param_array, i); // Some pages contain a null byte - \x00 in the input. Ugh.
-        if( strstr(item, search) == NULL )
+        if( y_find(item, strlen(item), search, search_len) == NULL )
         {
             y_array_save(item, result_array, j++);
         }
@@ -562,6 +1083,56 @@ void y_array_filter( const char *source_param_array, const char *search, const c
 }
 
 
+/*! \brief Search and replace a whole set of strings in a parameter in one pass, with the search/replace pairs taken from two parameter arrays.
+
+As y_replace_many(), with element N of the search array being replaced by element N of the replace array.
+The compiled set of pairs is cached, so if the arrays hold the same values next time around it is not rebuilt.
+
+\param [in] parameter The parameter to rewrite. The result is stored in the same parameter.
+\param [in] search_array The name of the parameter array holding the search strings.
+\param [in] replace_array The name of the parameter array holding the replacement strings. Must be the same size as the search array.
+\returns The number of replacements made.
+
+\b Example:
+\code
+y_array_save("John", "FROM", 1);
+y_array_save("Amsterdam", "FROM", 2);
+y_array_save_count(2, "FROM");
+y_array_save("Person1", "TO", 1);
+y_array_save("City1", "TO", 2);
+y_array_save_count(2, "TO");
+y_array_replace_many("Response", "FROM", "TO");   // Every "John" in {Response} becomes "Person1", every "Amsterdam" becomes "City1".
+\endcode
+\see y_replace_many()
+*/
+int y_array_replace_many(const char* parameter, const char* search_array, const char* replace_array)
+{
+    int count = y_array_count(search_array);
+    int i, result;
+    char **search, **replace;
+    y_arena_mark mark;
+
+    if( count != y_array_count(replace_array) )
+    {
+        lr_error_message("y_array_replace_many(): Arrays %s and %s differ in size!", search_array, replace_array);
+        lr_abort();
+        return 0;
+    }
+
+    mark = y_arena_get_mark();
+    search = (char**) y_arena_alloc(count * sizeof(char*) +1);
+    replace = (char**) y_arena_alloc(count * sizeof(char*) +1);
+    for( i = 0; i < count; i++ )
+    {
+        search[i] = y_array_get(search_array, i+1);
+        replace[i] = y_array_get(replace_array, i+1);
+    }
+    result = y_replace_many(parameter, search, replace, count);
+    y_arena_release(mark);
+    return result;
+}
+
+
 /*! Merge two parameter arrays into a single array. 
 
 \warning The source parameter arrays have to be of the same length.
@@ -596,9 +1167,8 @@ y_array_dump("RESULT");
 int y_array_merge(const char *param_array_left, const char *param_array_right, const char *separator, const char *result_array)
 {
     int i = 1;
-    char *param;
     int length = y_array_count(param_array_left);
-    int seperator_size = strlen(separator);
+    y_strbuf result;
 
     if( length != y_array_count(param_array_right) )
     {
@@ -609,19 +1179,23 @@ int y_array_merge(const char *param_array_left, const char *param_array_right, c
         return 0;
     }
 
+    y_strbuf_init(&result, 0);
     for( i=1; i <= length; i++)
     {
+        y_arena_mark mark = y_arena_get_mark();
         char *left = y_array_get_no_zeroes(param_array_left, i);
         char *right = y_array_get_no_zeroes(param_array_right, i);
-        size_t size = strlen(left)+seperator_size+strlen(right)+1;
-        char *result = y_mem_alloc(size);
 
-        snprintf(result, size, "%s%s%s", left, separator, right);
+        y_strbuf_reset(&result);
+        y_strbuf_append(&result, left);
+        y_strbuf_append(&result, separator);
+        y_strbuf_append(&result, right);
         lr_eval_string_ext_free(&left);
         lr_eval_string_ext_free(&right);
-        y_array_save(result, result_array, i);
-        free(result);
+        y_strbuf_save_to_param(&result, y_arena_array_element_name(result_array, i));
+        y_arena_release(mark);
     }
+    y_strbuf_free(&result);
     y_array_save_count(i-1, result_array);
     return 1;
 }
@@ -629,6 +1203,149 @@ int y_array_merge(const char *param_array_left, const char *param_array_right, c
 
 
 
+//! \cond internal_functions
+// Split a parameter into a parameter array, optionally honouring quotes. \sa y_split_all(), y_split_all_quoted()
+int y_split_all_core(const char* function_name, const char* param, const char* separator, const char* result_array, int max_fields, int quoted)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview text = y_get_parameter_view(param);
+    y_strview sep = y_strview_from_string(separator);
+    size_t pos = 0;
+    int count = 0;
+
+    if( text.ptr == NULL )
+    {
+        lr_error_message("%s(): Error: Parameter %s does not exist!", function_name, param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+    if( sep.len == 0 )
+    {
+        lr_error_message("%s(): Error: Empty separator passed.", function_name);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    while( text.len > 0 )
+    {
+        y_arena_mark element_mark = y_arena_get_mark();
+        y_strview rest = y_strview_slice(text, pos, text.len);
+        y_strview field;
+        int next = -1;
+
+        if( max_fields > 0 && count == max_fields -1 )
+        {
+            // The last field gets whatever is left, separators and all.
+            field = rest;
+        }
+        else if( quoted && rest.len > 0 && rest.ptr[0] == '"' )
+        {
+            // Quoted field: runs to the closing quote, with "" standing for a single quote. Anything between the closing quote and the separator is kept.
+            char* value = y_arena_alloc(rest.len);
+            size_t len = 0;
+            size_t i = 1;
+
+            while( i < rest.len )
+            {
+                if( rest.ptr[i] == '"' )
+                {
+                    if( i +1 < rest.len && rest.ptr[i +1] == '"' )
+                    {
+                        value[len++] = '"';
+                        i += 2;
+                        continue;
+                    }
+                    i++;
+                    break;
+                }
+                value[len++] = rest.ptr[i++];
+            }
+            next = y_strview_find(y_strview_slice(rest, i, rest.len), sep);
+            if( next >= 0 )
+            {
+                memcpy(value + len, rest.ptr + i, next);
+                len += next;
+                next += i;
+            }
+            else
+            {
+                memcpy(value + len, rest.ptr + i, rest.len - i);
+                len += rest.len - i;
+            }
+            field = y_strview_make(value, len);
+        }
+        else
+        {
+            next = y_strview_find(rest, sep);
+            field = y_strview_slice(rest, 0, next >= 0 ? (size_t) next : rest.len);
+        }
+
+        y_save_view(field, y_arena_array_element_name(result_array, ++count));
+        y_arena_release(element_mark);
+        if( next < 0 )
+        {
+            break;
+        }
+        pos += next + sep.len;
+    }
+
+    y_array_save_count(count, result_array);
+    y_arena_release(mark);
+    return count;
+}
+//! \endcond
+
+
+/*! \brief Split a parameter into a parameter array at every occurrence of a separator.
+
+Unlike repeated calls to y_split(), this scans the parameter once and copies every byte once, no matter how many fields there are.
+Empty fields are kept: splitting "a,,b," on "," gives "a", "", "b" and "". An empty parameter gives no fields at all. Binary safe.
+
+\param [in] param The parameter to split.
+\param [in] separator The separator between fields. Must not be empty.
+\param [in] result_array The name of the parameter array to save the fields in, as {result_array_1} .. {result_array_count}.
+\param [in] max_fields The maximum number of fields. The last field gets the rest of the parameter, including any separators in it. 0 for no limit.
+\returns The number of fields.
+
+\b Example:
+\code
+lr_save_string("2014-05-12;ORD-8812;shipped;;Amsterdam", "Record");
+y_split_all("Record", ";", "Field", 0);   // {Field_1} is "2014-05-12", {Field_4} is "", {Field_count} is 5
+y_split_all("Record", ";", "Field", 2);   // {Field_2} is "ORD-8812;shipped;;Amsterdam"
+\endcode
+\sa y_split_all_quoted(), y_split(), y_tokens_begin(), y_array_split()
+*/
+int y_split_all(const char* param, const char* separator, const char* result_array, int max_fields)
+{
+    return y_split_all_core("y_split_all", param, separator, result_array, max_fields, 0);
+}
+
+/*! \brief Split a parameter into a parameter array at every occurrence of a separator, except where the separator is quoted.
+
+As y_split_all(), but a field starting with a double quote runs to the next unpaired double quote, and separators in it are not split on.
+The quotes are removed, and two double quotes in a quoted field become one - the CSV convention. Fields that don't start with a quote are taken as they are.
+
+\param [in] param The parameter to split.
+\param [in] separator The separator between fields. Must not be empty.
+\param [in] result_array The name of the parameter array to save the fields in, as {result_array_1} .. {result_array_count}.
+\param [in] max_fields The maximum number of fields. The last field gets the rest of the parameter as it is. 0 for no limit.
+\returns The number of fields.
+
+\b Example:
+\code
+lr_save_string("42,\"Doe, John\",\"say \"\"hi\"\"\"", "Record");
+y_split_all_quoted("Record", ",", "Field", 0);   // {Field_2} is "Doe, John", {Field_3} is "say \"hi\""
+\endcode
+\sa y_split_all(), y_csv_parse()
+*/
+int y_split_all_quoted(const char* param, const char* separator, const char* result_array, int max_fields)
+{
+    return y_split_all_core("y_split_all_quoted", param, separator, result_array, max_fields, 1);
+}
+
+
 /*! Split an input array vertically into two new arrays, based on a search parameter.
 
 This is the reverse of y_array_merge(). It will examine each parameter in turn and save each value into two separate parameter lists.
@@ -640,7 +1357,7 @@ This is the reverse of y_array_merge(). It will examine each parameter in turn a
 \param [in] param_array_left The parameter array to use for the lefthand side of the concatenations. Can be the same as the input array.
 \param [in] param_array_right The parameter array to use for the righthand side of the concatenations. Can also be the same as the input array.
 
-\see y_array_merge(), y_array_concat(), y_array_pick_random(), y_split_str()
+\see y_array_merge(), y_array_concat(), y_array_pick_random(), y_split_str(), y_split_all()
 \author Floris Kraak
 */
 void y_array_split(const char *source_param_array, const char *separator, const char *param_array_left, const char *param_array_right)
@@ -652,21 +1369,16 @@ void y_array_split(const char *source_param_array, const char *separator, const
 
     for( i=1; i <= size; i++)
     {
+        y_arena_mark mark = y_arena_get_mark();
         char *item = y_array_get_no_zeroes(source_param_array, i);
-        int len = strlen(item);
-        char *left = y_mem_alloc(len);
-        char *right = y_mem_alloc(len);
-
-        left[0] = '\0';
-        right[0] = '\0';
+        y_strview left, right;
 
-        y_split_str(item, separator, left, right);
+        // Split in place: both halves are views on the item, so nothing is copied before saving.
+        y_split_view(y_strview_from_string(item), y_strview_from_string(separator), &left, &right);
+        y_save_view(left, y_arena_array_element_name(param_array_left, i));
+        y_save_view(right, y_arena_array_element_name(param_array_right, i));
         lr_eval_string_ext_free(&item);
-
-        y_array_save(left, param_array_left, i);
-        free(left);
-        y_array_save(right, param_array_right, i);
-        free(right);
+        y_arena_release(mark);
     }
 
     y_array_save_count(i-1,param_array_left);
@@ -700,6 +1412,7 @@ void y_array_shuffle(char *source_param_array, char *result_array)
 {
     int *shuffle;
     int source_length, i;
+    y_arena_mark mark;
 
     if (strcmp(source_param_array, result_array) == 0)
     {
@@ -724,7 +1437,8 @@ void y_array_shuffle(char *source_param_array, char *result_array)
     }
 
     // Now the cases where we can actually shuffle something: 
-    shuffle=(int *)y_array_alloc(source_length+1, sizeof(int)); // Allocate room for an array of ints.
+    mark = y_arena_get_mark();
+    shuffle=(int *)y_arena_alloc((source_length+1) * sizeof(int)); // Allocate room for an array of ints.
     for (i=1; i<=source_length; i++) // Fill it with the numbers 1 .. source length, denoting indexes into the source array, unshuffled.
     {
         //lr_message("i: %d", i);    
@@ -751,7 +1465,7 @@ void y_array_shuffle(char *source_param_array, char *result_array)
            result_array, i);
     }
     y_array_save_count(--i, result_array); // We can probably just use the source_length here instead.
-    free (shuffle);
+    y_arena_release(mark);
 }
 
 #endif // _Y_PARAM_ARRAY_C_
@@ -0,0 +1,1397 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_regex.c
+\brief Regular expressions for correlation.
+
+A small regular expression engine, meant for pulling values out of responses in one go rather than with chains of
+y_left(), y_right() and y_chop() calls.
+
+Patterns are compiled once and cached for the rest of the test. Searching uses a lazily built DFA (deterministic automaton) to find
+where a match starts and ends in a single linear scan. Only the matched text itself is then run through a slower NFA simulation
+to find the capture groups. After the first few searches no memory is allocated at all.
+
+Supported syntax:
+- Literal characters, and escapes: \\t \\n \\r \\f \\v \\xHH, and \\ followed by any punctuation character for the character itself.
+- Character classes: . (anything but a newline), [abc], [^abc], [a-z], \\d \\D \\w \\W \\s \\S (also inside [...]).
+- Groups: ( ) captures, (?: ) does not.
+- Alternation: |
+- Repetition: * + ? {n} {n,} {n,m}. Append ? to any of those for the non-greedy ('lazy') version.
+- Anchors: ^ at the very start of a pattern and $ at the very end. They apply to the pattern as a whole, also when it contains
+  alternatives: "^a|b" only matches at the start of the text. Anywhere else they are errors.
+- Case insensitive matching: start the pattern with (?i)
+
+Matching is "leftmost first", like Perl and most other engines: the match that starts earliest wins, and among those the alternatives
+and repetitions are tried in the order the pattern implies. Backreferences and lookaround are not supported - they cannot be matched in linear time.
+Repeating something that can match the empty string, such as (a??)*, may produce a different (but still valid) match than Perl would.
+
+\b Example:
+\code
+web_reg_save_param("Body", "LB=", "RB=", "Search=Body", LAST);
+web_url("form", "URL=http://www.example.com/form", LAST);
+y_regex_match("Body", "name=\"token\" value=\"([^\"]*)\"", "Token");  // {Token} holds the value of the token field
+y_regex_extract_all("Body", "<a href=\"([^\"]+)\"", "Links");        // {Links_1} .. {Links_count} hold all links
+\endcode
+*/
+#ifndef _Y_REGEX_C_
+//! \cond include_protection
+#define _Y_REGEX_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_string.c"
+#include "y_param_array.c"
+
+//! \brief The maximum number of capture groups in a pattern, including group 0 (the entire match).
+#define Y_REGEX_MAX_GROUPS 32
+//! \brief The maximum number of instructions a compiled pattern may have. Mostly a limit on large {n,m} repeats.
+#define Y_REGEX_MAX_PROGRAM 8192
+/*! \brief The maximum number of DFA states per pattern.
+Patterns that need more than this fall back to the (slower, but still linear) NFA simulation.
+*/
+#define Y_REGEX_DFA_MAX_STATES 1024
+
+//! \cond internal_global
+// Instruction opcodes.
+#define Y_RE_CHAR 1     // Consume a byte that is in set x
+#define Y_RE_MATCH 2    // Done
+#define Y_RE_JMP 3      // Continue at x
+#define Y_RE_SPLIT 4    // Continue at x and y, preferring x
+#define Y_RE_SAVE 5     // Record the current position in capture slot x
+
+// Parse tree node types.
+#define Y_RE_NODE_EMPTY 0
+#define Y_RE_NODE_SET 1
+#define Y_RE_NODE_CAT 2
+#define Y_RE_NODE_ALT 3
+#define Y_RE_NODE_REPEAT 4
+#define Y_RE_NODE_GROUP 5
+
+// DFA state flags.
+#define Y_RE_STATE_MATCH 1    // The state contains the match instruction
+#define Y_RE_STATE_MATCHED 2  // A match has been seen; no new match attempts are started
+
+// DFA transition markers.
+#define Y_RE_DEAD -1
+#define Y_RE_UNKNOWN -2
+//! \endcond
+
+//! \brief A single instruction of a compiled pattern. \sa y_struct_regex
+struct y_struct_regex_inst
+{
+    //! The opcode.
+    int op;
+    //! First argument.
+    int x;
+    //! Second argument.
+    int y;
+};
+//! \brief A single instruction of a compiled pattern.
+typedef struct y_struct_regex_inst y_regex_inst;
+
+//! \brief A node in the parse tree of a pattern. Only used while compiling.
+struct y_struct_regex_node
+{
+    //! The node type.
+    int type;
+    //! The first (or only) child.
+    int a;
+    //! The second child.
+    int b;
+    //! For repeats: the minimum count. For sets: the set number. For groups: the group number, or -1.
+    int min;
+    //! For repeats: the maximum count, or -1 for no maximum.
+    int max;
+    //! For repeats: non-zero if greedy.
+    int greedy;
+};
+//! \brief A node in the parse tree of a pattern.
+typedef struct y_struct_regex_node y_regex_node;
+
+/*! \brief A lazily built DFA over one of the programs of a compiled pattern.
+
+Every DFA state stands for an ordered list of NFA threads. States and their transitions are created the first time they are needed.
+\sa y_struct_regex
+*/
+struct y_struct_regex_dfa
+{
+    //! The program this DFA runs.
+    y_regex_inst* prog;
+    //! The length of the program.
+    int prog_len;
+    //! Non-zero to look for the longest match instead of the leftmost first match.
+    int longest;
+    //! Non-zero to start a new match attempt at every position.
+    int unanchored;
+    //! Non-zero if a match only counts at the end of the text.
+    int anchored_end;
+    //! The number of states.
+    int state_count;
+    //! Non-zero once the DFA has run out of states. The NFA simulation is used instead from then on.
+    int failed;
+    //! For each state, the program counters of it's threads.
+    int** state_pcs;
+    //! For each state, the number of threads.
+    int* state_len;
+    //! For each state, Y_RE_STATE_* flags.
+    int* state_flags;
+    //! For each state, class_count transitions.
+    int** state_next;
+    //! Hash table over the states. Holds state numbers +1, 0 means empty.
+    int* table;
+    //! Scratch space: visit marks per instruction.
+    int* mark;
+    //! Scratch space: the current generation for mark.
+    int generation;
+    //! Scratch space: a stack.
+    int* stack;
+    //! Scratch space: the thread list being built.
+    int* list;
+};
+//! \brief A lazily built DFA.
+typedef struct y_struct_regex_dfa y_regex_dfa;
+
+/*! \brief A compiled regular expression.
+\sa y_regex_compile()
+*/
+struct y_struct_regex
+{
+    //! The next pattern in the cache.
+    struct y_struct_regex* next;
+    //! The pattern this was compiled from.
+    char* pattern;
+    //! The number of groups, including group 0.
+    int group_count;
+    //! Non-zero if the pattern started with ^
+    int anchored_start;
+    //! Non-zero if the pattern ended with $
+    int anchored_end;
+    //! Non-zero if the pattern started with (?i)
+    int ignore_case;
+    //! The byte sets used by Y_RE_CHAR instructions, 32 bytes each.
+    unsigned char* sets;
+    //! The number of byte sets.
+    int set_count;
+    //! Maps each byte to it's byte class. Bytes in the same class are in exactly the same sets.
+    unsigned char byte_class[256];
+    //! One byte out of each byte class.
+    unsigned char class_byte[256];
+    //! The number of byte classes.
+    int class_count;
+    //! The forward program, with captures.
+    y_regex_inst* prog;
+    //! The length of the forward program.
+    int prog_len;
+    //! The reverse program, without captures. Used to find where a match starts.
+    y_regex_inst* rev_prog;
+    //! The length of the reverse program.
+    int rev_prog_len;
+    //! DFA finding match ends.
+    y_regex_dfa forward;
+    //! DFA finding match starts.
+    y_regex_dfa reverse;
+    //! NFA simulation scratch space: program counters of the current and next thread lists.
+    int* thread_pcs[2];
+    //! NFA simulation scratch space: capture slots of the current and next thread lists.
+    int* thread_caps[2];
+    //! NFA simulation scratch space: capture slots being built.
+    int* caps;
+    //! NFA simulation scratch space: visit marks per instruction.
+    int* mark;
+    //! NFA simulation scratch space: the current generation for mark.
+    int generation;
+    //! NFA simulation scratch space: a stack of (pc, slot, value) triples.
+    int* stack;
+};
+//! \brief A compiled regular expression. \sa y_regex_compile()
+typedef struct y_struct_regex y_regex;
+
+//! \brief State of the pattern parser and compiler. Only used while compiling.
+struct y_struct_regex_parser
+{
+    //! The pattern.
+    const char* pattern;
+    //! Current position in the pattern.
+    const char* pos;
+    //! The compiled pattern being built.
+    y_regex* re;
+    //! The parse tree.
+    y_regex_node* nodes;
+    //! The number of nodes.
+    int node_count;
+    //! Space for nodes.
+    int node_capacity;
+    //! Space for sets.
+    int set_capacity;
+    //! The error message, or NULL.
+    const char* error;
+};
+//! \brief State of the pattern parser and compiler.
+typedef struct y_struct_regex_parser y_regex_parser;
+
+//! \cond internal_global
+//! INTERNAL: Cache of compiled patterns. \sa y_regex_compile()
+y_regex* _y_regexes = NULL;
+//! \endcond
+
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Parser
+// ---------------------------------------------------------------------------------------------------------------------------
+
+//! \cond internal_functions
+int y_regex_new_node(y_regex_parser* p, int type, int a, int b)
+{
+    y_regex_node* node;
+    if( p->node_count >= p->node_capacity )
+    {
+        p->error = "pattern too complex";
+        return 0;
+    }
+    node = &p->nodes[p->node_count];
+    node->type = type;
+    node->a = a;
+    node->b = b;
+    node->min = node->max = -1;
+    node->greedy = 1;
+    return p->node_count++;
+}
+
+int y_regex_new_set(y_regex_parser* p)
+{
+    if( p->re->set_count >= p->set_capacity )
+    {
+        p->error = "pattern too complex";
+        return 0;
+    }
+    memset(p->re->sets + p->re->set_count * 32, 0, 32);
+    return p->re->set_count++;
+}
+
+void y_regex_set_add(y_regex_parser* p, int set, int c)
+{
+    unsigned char* bits = p->re->sets + set * 32;
+    bits[c >> 3] |= 1 << (c & 7);
+    if( p->re->ignore_case && isalpha(c) )
+    {
+        int other = isupper(c) ? tolower(c) : toupper(c);
+        bits[other >> 3] |= 1 << (other & 7);
+    }
+}
+
+void y_regex_set_add_range(y_regex_parser* p, int set, int from, int to)
+{
+    int c;
+    for( c = from; c <= to; c++ )
+    {
+        y_regex_set_add(p, set, c);
+    }
+}
+
+// Add the bytes for the class escape c (d, w, s and their negations) to a set. Returns 0 if c is not a class escape.
+int y_regex_set_add_escape_class(y_regex_parser* p, int set, int c)
+{
+    int b;
+    int negate = isupper(c);
+    int lower = tolower(c);
+
+    if( lower != 'd' && lower != 'w' && lower != 's' )
+    {
+        return 0;
+    }
+    for( b = 0; b < 256; b++ )
+    {
+        int in = (lower == 'd' && b >= '0' && b <= '9') ||
+                 (lower == 'w' && ((b >= 'a' && b <= 'z') || (b >= 'A' && b <= 'Z') || (b >= '0' && b <= '9') || b == '_')) ||
+                 (lower == 's' && (b == ' ' || b == '\t' || b == '\n' || b == '\r' || b == '\f' || b == '\v'));
+        if( in != negate )
+        {
+            unsigned char* bits = p->re->sets + set * 32;
+            bits[b >> 3] |= 1 << (b & 7);
+        }
+    }
+    return 1;
+}
+
+int y_regex_hex_digit(int c)
+{
+    if( c >= '0' && c <= '9' ) return c - '0';
+    if( c >= 'a' && c <= 'f' ) return c - 'a' + 10;
+    if( c >= 'A' && c <= 'F' ) return c - 'A' + 10;
+    return -1;
+}
+
+// Parse a single (escaped) character after a backslash. Returns the byte value, or -1 on error.
+int y_regex_parse_escape(y_regex_parser* p)
+{
+    int c = (unsigned char) *p->pos;
+    int h1, h2;
+
+    if( c == '\0' )
+    {
+        p->error = "pattern ends in a backslash";
+        return -1;
+    }
+    p->pos++;
+    switch( c )
+    {
+        case 't': return '\t';
+        case 'n': return '\n';
+        case 'r': return '\r';
+        case 'f': return '\f';
+        case 'v': return '\v';
+        case 'x':
+            h1 = y_regex_hex_digit(p->pos[0]);
+            h2 = h1 < 0 ? -1 : y_regex_hex_digit(p->pos[1]);
+            if( h2 < 0 )
+            {
+                p->error = "\\x must be followed by two hex digits";
+                return -1;
+            }
+            p->pos += 2;
+            return h1 * 16 + h2;
+    }
+    if( isalnum(c) )
+    {
+        p->error = "unknown escape sequence";
+        return -1;
+    }
+    return c;
+}
+
+int y_regex_parse_class(y_regex_parser* p)
+{
+    int set = y_regex_new_set(p);
+    int negate = 0;
+    int first = 1;
+    int c;
+
+    if( *p->pos == '^' )
+    {
+        negate = 1;
+        p->pos++;
+    }
+    while( first || *p->pos != ']' )
+    {
+        first = 0;
+        if( *p->pos == '\0' )
+        {
+            p->error = "missing ]";
+            return 0;
+        }
+        c = (unsigned char) *p->pos++;
+        if( c == '\\' )
+        {
+            if( y_regex_set_add_escape_class(p, set, *p->pos) )
+            {
+                p->pos++;
+                continue;
+            }
+            if( (c = y_regex_parse_escape(p)) < 0 )
+                return 0;
+        }
+        if( p->pos[0] == '-' && p->pos[1] != ']' && p->pos[1] != '\0' )
+        {
+            int to;
+            p->pos++;
+            to = (unsigned char) *p->pos++;
+            if( to == '\\' && (to = y_regex_parse_escape(p)) < 0 )
+                return 0;
+            if( to < c )
+            {
+                p->error = "invalid range in []";
+                return 0;
+            }
+            y_regex_set_add_range(p, set, c, to);
+        }
+        else
+        {
+            y_regex_set_add(p, set, c);
+        }
+    }
+    p->pos++; // ]
+
+    if( negate )
+    {
+        unsigned char* bits = p->re->sets + set * 32;
+        for( c = 0; c < 32; c++ )
+        {
+            bits[c] = ~bits[c];
+        }
+    }
+    return y_regex_new_node(p, Y_RE_NODE_SET, set, 0);
+}
+
+int y_regex_parse_alternation(y_regex_parser* p);
+
+int y_regex_parse_atom(y_regex_parser* p)
+{
+    int c = (unsigned char) *p->pos;
+    int set, node;
+
+    switch( c )
+    {
+        case '(':
+            p->pos++;
+            if( p->pos[0] == '?' && p->pos[1] == ':' )
+            {
+                p->pos += 2;
+                node = y_regex_new_node(p, Y_RE_NODE_GROUP, y_regex_parse_alternation(p), 0);
+                p->nodes[node].min = -1;
+            }
+            else
+            {
+                int group = p->re->group_count++;
+                if( group >= Y_REGEX_MAX_GROUPS )
+                {
+                    p->error = "too many groups";
+                    return 0;
+                }
+                node = y_regex_new_node(p, Y_RE_NODE_GROUP, y_regex_parse_alternation(p), 0);
+                p->nodes[node].min = group;
+            }
+            if( p->error )
+                return 0;
+            if( *p->pos != ')' )
+            {
+                p->error = "missing )";
+                return 0;
+            }
+            p->pos++;
+            return node;
+
+        case '[':
+            p->pos++;
+            return y_regex_parse_class(p);
+
+        case '.':
+            p->pos++;
+            set = y_regex_new_set(p);
+            y_regex_set_add_range(p, set, 0, 255);
+            p->re->sets[set * 32 + ('\n' >> 3)] &= ~(1 << ('\n' & 7));
+            return y_regex_new_node(p, Y_RE_NODE_SET, set, 0);
+
+        case '*':
+        case '+':
+        case '?':
+            p->error = "nothing to repeat";
+            return 0;
+
+        case '^':
+            p->error = "^ is only supported at the start of the pattern";
+            return 0;
+
+        case '$':
+            p->error = "$ is only supported at the end of the pattern";
+            return 0;
+
+        case '\\':
+            p->pos++;
+            set = y_regex_new_set(p);
+            if( y_regex_set_add_escape_class(p, set, *p->pos) )
+            {
+                p->pos++;
+                return y_regex_new_node(p, Y_RE_NODE_SET, set, 0);
+            }
+            if( (c = y_regex_parse_escape(p)) < 0 )
+                return 0;
+            y_regex_set_add(p, set, c);
+            return y_regex_new_node(p, Y_RE_NODE_SET, set, 0);
+    }
+
+    p->pos++;
+    set = y_regex_new_set(p);
+    y_regex_set_add(p, set, c);
+    return y_regex_new_node(p, Y_RE_NODE_SET, set, 0);
+}
+
+// Parse a {n}, {n,} or {n,m} repeat count. Returns 0 if this isn't one - the { is then taken literally.
+int y_regex_parse_count(y_regex_parser* p, int* min, int* max)
+{
+    const char* s = p->pos +1;
+    char* end;
+
+    if( !isdigit(*s) )
+        return 0;
+    *min = strtol(s, &end, 10);
+    s = end;
+    if( *s == '}' )
+    {
+        *max = *min;
+    }
+    else if( *s == ',' && s[1] == '}' )
+    {
+        *max = -1;
+        s++;
+    }
+    else if( *s == ',' && isdigit(s[1]) )
+    {
+        *max = strtol(s +1, &end, 10);
+        s = end;
+        if( *s != '}' )
+            return 0;
+    }
+    else
+    {
+        return 0;
+    }
+    p->pos = s +1;
+    return 1;
+}
+
+int y_regex_parse_repeat(y_regex_parser* p)
+{
+    int node = y_regex_parse_atom(p);
+
+    while( !p->error )
+    {
+        int min, max;
+        int c = *p->pos;
+
+        if( c == '*' )      { min = 0; max = -1; p->pos++; }
+        else if( c == '+' ) { min = 1; max = -1; p->pos++; }
+        else if( c == '?' ) { min = 0; max = 1;  p->pos++; }
+        else if( c == '{' && y_regex_parse_count(p, &min, &max) )
+        {
+            if( (max >= 0 && max < min) || min > 1000 || max > 1000 )
+            {
+                p->error = "invalid repeat count";
+                return 0;
+            }
+        }
+        else break;
+
+        node = y_regex_new_node(p, Y_RE_NODE_REPEAT, node, 0);
+        p->nodes[node].min = min;
+        p->nodes[node].max = max;
+        if( *p->pos == '?' )
+        {
+            p->nodes[node].greedy = 0;
+            p->pos++;
+        }
+    }
+    return node;
+}
+
+int y_regex_parse_concatenation(y_regex_parser* p)
+{
+    int node = y_regex_new_node(p, Y_RE_NODE_EMPTY, 0, 0);
+
+    while( !p->error && *p->pos != '\0' && *p->pos != '|' && *p->pos != ')' )
+    {
+        int next;
+        if( *p->pos == '$' && p->pos[1] == '\0' )
+        {
+            p->re->anchored_end = 1;
+            break;
+        }
+        next = y_regex_parse_repeat(p);
+        node = p->nodes[node].type == Y_RE_NODE_EMPTY ? next : y_regex_new_node(p, Y_RE_NODE_CAT, node, next);
+    }
+    return node;
+}
+
+int y_regex_parse_alternation(y_regex_parser* p)
+{
+    int node = y_regex_parse_concatenation(p);
+
+    while( !p->error && *p->pos == '|' )
+    {
+        p->pos++;
+        node = y_regex_new_node(p, Y_RE_NODE_ALT, node, y_regex_parse_concatenation(p));
+    }
+    return node;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Compiler
+// ---------------------------------------------------------------------------------------------------------------------------
+
+int y_regex_emit(y_regex_parser* p, y_regex_inst* prog, int* len, int op, int x, int y)
+{
+    if( *len >= Y_REGEX_MAX_PROGRAM )
+    {
+        p->error = "pattern too large";
+        return 0;
+    }
+    prog[*len].op = op;
+    prog[*len].x = x;
+    prog[*len].y = y;
+    return (*len)++;
+}
+
+// Compile a parse tree node into prog. For the reverse program, concatenations are reversed and captures are left out.
+void y_regex_emit_node(y_regex_parser* p, int n, y_regex_inst* prog, int* len, int reverse)
+{
+    y_regex_node* node = &p->nodes[n];
+    int i, split, jmp;
+
+    if( p->error )
+        return;
+
+    switch( node->type )
+    {
+        case Y_RE_NODE_SET:
+            y_regex_emit(p, prog, len, Y_RE_CHAR, node->a, 0);
+            break;
+
+        case Y_RE_NODE_CAT:
+            y_regex_emit_node(p, reverse ? node->b : node->a, prog, len, reverse);
+            y_regex_emit_node(p, reverse ? node->a : node->b, prog, len, reverse);
+            break;
+
+        case Y_RE_NODE_ALT:
+            split = y_regex_emit(p, prog, len, Y_RE_SPLIT, 0, 0);
+            prog[split].x = *len;
+            y_regex_emit_node(p, node->a, prog, len, reverse);
+            jmp = y_regex_emit(p, prog, len, Y_RE_JMP, 0, 0);
+            prog[split].y = *len;
+            y_regex_emit_node(p, node->b, prog, len, reverse);
+            prog[jmp].x = *len;
+            break;
+
+        case Y_RE_NODE_GROUP:
+            if( node->min >= 0 && !reverse )
+                y_regex_emit(p, prog, len, Y_RE_SAVE, node->min * 2, 0);
+            y_regex_emit_node(p, node->a, prog, len, reverse);
+            if( node->min >= 0 && !reverse )
+                y_regex_emit(p, prog, len, Y_RE_SAVE, node->min * 2 +1, 0);
+            break;
+
+        case Y_RE_NODE_REPEAT:
+            for( i = 0; i < node->min && !p->error; i++ )
+            {
+                y_regex_emit_node(p, node->a, prog, len, reverse);
+            }
+            if( node->max < 0 )
+            {
+                // L: split body, out; body; jmp L; out:
+                split = y_regex_emit(p, prog, len, Y_RE_SPLIT, 0, 0);
+                y_regex_emit_node(p, node->a, prog, len, reverse);
+                y_regex_emit(p, prog, len, Y_RE_JMP, split, 0);
+                if( node->greedy ) { prog[split].x = split +1; prog[split].y = *len; }
+                else               { prog[split].x = *len; prog[split].y = split +1; }
+            }
+            else
+            {
+                for( i = node->min; i < node->max && !p->error; i++ )
+                {
+                    split = y_regex_emit(p, prog, len, Y_RE_SPLIT, 0, 0);
+                    y_regex_emit_node(p, node->a, prog, len, reverse);
+                    if( node->greedy ) { prog[split].x = split +1; prog[split].y = *len; }
+                    else               { prog[split].x = *len; prog[split].y = split +1; }
+                }
+            }
+            break;
+    }
+}
+
+// Split the 256 byte values into classes of bytes that are in exactly the same sets.
+void y_regex_compute_byte_classes(y_regex* re)
+{
+    int map[512];
+    int s, b;
+
+    memset(re->byte_class, 0, sizeof(re->byte_class));
+    re->class_count = 1;
+    for( s = 0; s < re->set_count; s++ )
+    {
+        unsigned char* bits = re->sets + s * 32;
+        int count = 0;
+
+        // Refine: every (old class, in set) pair becomes a new class.
+        for( b = 0; b < 512; b++ )
+            map[b] = -1;
+        for( b = 0; b < 256; b++ )
+        {
+            int key = re->byte_class[b] * 2 + ((bits[b >> 3] >> (b & 7)) & 1);
+            if( map[key] < 0 )
+                map[key] = count++;
+            re->byte_class[b] = map[key];
+        }
+        re->class_count = count;
+    }
+    for( b = 255; b >= 0; b-- )
+    {
+        re->class_byte[re->byte_class[b]] = b;
+    }
+}
+
+void y_regex_dfa_init(y_regex_dfa* dfa, y_regex_inst* prog, int prog_len, int longest, int unanchored, int anchored_end)
+{
+    memset(dfa, 0, sizeof(y_regex_dfa));
+    dfa->prog = prog;
+    dfa->prog_len = prog_len;
+    dfa->longest = longest;
+    dfa->unanchored = unanchored;
+    dfa->anchored_end = anchored_end;
+    dfa->state_pcs = (int**) y_array_alloc(Y_REGEX_DFA_MAX_STATES, sizeof(int*));
+    dfa->state_len = (int*) y_array_alloc(Y_REGEX_DFA_MAX_STATES, sizeof(int));
+    dfa->state_flags = (int*) y_array_alloc(Y_REGEX_DFA_MAX_STATES, sizeof(int));
+    dfa->state_next = (int**) y_array_alloc(Y_REGEX_DFA_MAX_STATES, sizeof(int*));
+    dfa->table = (int*) y_array_alloc(Y_REGEX_DFA_MAX_STATES * 2, sizeof(int));
+    dfa->mark = (int*) y_array_alloc(prog_len, sizeof(int));
+    dfa->stack = (int*) y_array_alloc(prog_len * 2 +2, sizeof(int));
+    dfa->list = (int*) y_array_alloc(prog_len * 2 +2, sizeof(int));
+}
+
+y_regex* y_regex_compile_pattern(const char* pattern, const char** error)
+{
+    y_regex_parser parser;
+    y_regex_parser* p = &parser;
+    y_regex* re = (y_regex*) y_array_alloc(1, sizeof(y_regex));
+    size_t pattern_len = strlen(pattern);
+    int root;
+    int slots;
+
+    memset(p, 0, sizeof(y_regex_parser));
+    p->pattern = pattern;
+    p->pos = pattern;
+    p->re = re;
+    p->node_capacity = pattern_len * 2 + 8;
+    p->nodes = (y_regex_node*) y_mem_alloc(p->node_capacity * sizeof(y_regex_node));
+    p->set_capacity = pattern_len + 1;
+    re->sets = (unsigned char*) y_mem_alloc(p->set_capacity * 32);
+    re->group_count = 1;
+
+    // Flags and anchors.
+    if( strncmp(p->pos, "(?i)", 4) == 0 )
+    {
+        re->ignore_case = 1;
+        p->pos += 4;
+    }
+    if( *p->pos == '^' )
+    {
+        re->anchored_start = 1;
+        p->pos++;
+    }
+
+    root = y_regex_parse_alternation(p);
+    if( !p->error && *p->pos == '$' && re->anchored_end )
+        p->pos++;
+    if( !p->error && *p->pos != '\0' )
+        p->error = *p->pos == ')' ? "unmatched )" : "$ is only supported at the end of the pattern";
+
+    if( !p->error )
+    {
+        // Forward program: save 0, pattern, save 1, match.
+        re->prog = (y_regex_inst*) y_mem_alloc(Y_REGEX_MAX_PROGRAM * sizeof(y_regex_inst));
+        y_regex_emit(p, re->prog, &re->prog_len, Y_RE_SAVE, 0, 0);
+        y_regex_emit_node(p, root, re->prog, &re->prog_len, 0);
+        y_regex_emit(p, re->prog, &re->prog_len, Y_RE_SAVE, 1, 0);
+        y_regex_emit(p, re->prog, &re->prog_len, Y_RE_MATCH, 0, 0);
+
+        // Reverse program.
+        re->rev_prog = (y_regex_inst*) y_mem_alloc(Y_REGEX_MAX_PROGRAM * sizeof(y_regex_inst));
+        y_regex_emit_node(p, root, re->rev_prog, &re->rev_prog_len, 1);
+        y_regex_emit(p, re->rev_prog, &re->rev_prog_len, Y_RE_MATCH, 0, 0);
+    }
+    free(p->nodes);
+
+    if( p->error )
+    {
+        *error = p->error;
+        free(re->prog);
+        free(re->rev_prog);
+        free(re->sets);
+        free(re);
+        return NULL;
+    }
+
+    y_regex_compute_byte_classes(re);
+    y_regex_dfa_init(&re->forward, re->prog, re->prog_len, 0, !re->anchored_start, re->anchored_end);
+    y_regex_dfa_init(&re->reverse, re->rev_prog, re->rev_prog_len, 1, 0, 0);
+
+    slots = re->group_count * 2;
+    re->thread_pcs[0] = (int*) y_array_alloc(re->prog_len, sizeof(int));
+    re->thread_pcs[1] = (int*) y_array_alloc(re->prog_len, sizeof(int));
+    re->thread_caps[0] = (int*) y_array_alloc(re->prog_len * slots, sizeof(int));
+    re->thread_caps[1] = (int*) y_array_alloc(re->prog_len * slots, sizeof(int));
+    re->caps = (int*) y_array_alloc(slots, sizeof(int));
+    re->mark = (int*) y_array_alloc(re->prog_len, sizeof(int));
+    re->stack = (int*) y_array_alloc(re->prog_len * 9 +9, sizeof(int));
+    return re;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// DFA
+// ---------------------------------------------------------------------------------------------------------------------------
+
+// Add the threads reachable from pc without consuming input to dfa->list, in priority order.
+// Returns non-zero if a match instruction was added and lower priority threads should be cut off.
+int y_regex_dfa_closure(y_regex_dfa* dfa, int pc, int* len)
+{
+    int top = 0;
+
+    dfa->stack[top++] = pc;
+    while( top > 0 )
+    {
+        y_regex_inst* inst;
+        pc = dfa->stack[--top];
+        if( dfa->mark[pc] == dfa->generation )
+            continue;
+        dfa->mark[pc] = dfa->generation;
+        inst = &dfa->prog[pc];
+
+        switch( inst->op )
+        {
+            case Y_RE_JMP:
+                dfa->stack[top++] = inst->x;
+                break;
+            case Y_RE_SPLIT:
+                dfa->stack[top++] = inst->y;
+                dfa->stack[top++] = inst->x;
+                break;
+            case Y_RE_SAVE:
+                dfa->stack[top++] = pc +1;
+                break;
+            case Y_RE_MATCH:
+                dfa->list[(*len)++] = pc;
+                if( !dfa->longest && !dfa->anchored_end )
+                    return 1;
+                break;
+            default:
+                dfa->list[(*len)++] = pc;
+                break;
+        }
+    }
+    return 0;
+}
+
+// Find or create the state for the thread list in dfa->list. Returns the state number, Y_RE_DEAD, or Y_RE_UNKNOWN if the DFA is full.
+int y_regex_dfa_state(y_regex* re, y_regex_dfa* dfa, int len, int flags)
+{
+    unsigned int hash = y_hash_string((const char*) dfa->list, len * sizeof(int)) ^ flags;
+    int slot = hash & (Y_REGEX_DFA_MAX_STATES * 2 -1);
+    int i, state;
+
+    if( len == 0 )
+        return Y_RE_DEAD;
+
+    while( dfa->table[slot] != 0 )
+    {
+        state = dfa->table[slot] -1;
+        if( dfa->state_len[state] == len && dfa->state_flags[state] == flags && memcmp(dfa->state_pcs[state], dfa->list, len * sizeof(int)) == 0 )
+            return state;
+        slot = (slot +1) & (Y_REGEX_DFA_MAX_STATES * 2 -1);
+    }
+
+    if( dfa->state_count >= Y_REGEX_DFA_MAX_STATES )
+    {
+        dfa->failed = 1;
+        return Y_RE_UNKNOWN;
+    }
+
+    state = dfa->state_count++;
+    dfa->state_pcs[state] = (int*) y_mem_alloc(len * sizeof(int));
+    memcpy(dfa->state_pcs[state], dfa->list, len * sizeof(int));
+    dfa->state_len[state] = len;
+    dfa->state_flags[state] = flags;
+    dfa->state_next[state] = (int*) y_mem_alloc(re->class_count * sizeof(int));
+    for( i = 0; i < re->class_count; i++ )
+        dfa->state_next[state][i] = Y_RE_UNKNOWN;
+    dfa->table[slot] = state +1;
+    return state;
+}
+
+int y_regex_dfa_flags(y_regex_dfa* dfa, int len, int flags)
+{
+    int i;
+    for( i = 0; i < len; i++ )
+    {
+        if( dfa->prog[dfa->list[i]].op == Y_RE_MATCH )
+            flags |= Y_RE_STATE_MATCH;
+    }
+    if( (flags & Y_RE_STATE_MATCH) && !dfa->longest && !dfa->anchored_end )
+        flags |= Y_RE_STATE_MATCHED;
+    return flags;
+}
+
+int y_regex_dfa_start(y_regex* re, y_regex_dfa* dfa)
+{
+    int len = 0;
+    dfa->generation++;
+    y_regex_dfa_closure(dfa, 0, &len);
+    return y_regex_dfa_state(re, dfa, len, y_regex_dfa_flags(dfa, len, 0));
+}
+
+// Compute the transition of a state on a byte class.
+int y_regex_dfa_step(y_regex* re, y_regex_dfa* dfa, int state, int byte_class)
+{
+    int* pcs = dfa->state_pcs[state];
+    int count = dfa->state_len[state];
+    int flags = dfa->state_flags[state] & Y_RE_STATE_MATCHED;
+    int c = re->class_byte[byte_class];
+    int len = 0;
+    int cut = 0;
+    int i, next;
+
+    dfa->generation++;
+    for( i = 0; i < count && !cut; i++ )
+    {
+        y_regex_inst* inst = &dfa->prog[pcs[i]];
+        if( inst->op == Y_RE_MATCH )
+        {
+            cut = !dfa->longest && !dfa->anchored_end; // lower priority threads lose
+            continue;
+        }
+        if( (re->sets[inst->x * 32 + (c >> 3)] >> (c & 7)) & 1 )
+        {
+            cut = y_regex_dfa_closure(dfa, pcs[i] +1, &len);
+        }
+    }
+    if( dfa->unanchored && !cut && !(flags & Y_RE_STATE_MATCHED) )
+    {
+        y_regex_dfa_closure(dfa, 0, &len);
+    }
+
+    next = y_regex_dfa_state(re, dfa, len, y_regex_dfa_flags(dfa, len, flags));
+    if( next != Y_RE_UNKNOWN )
+        dfa->state_next[state][byte_class] = next;
+    return next;
+}
+
+// Run the forward DFA from start. Returns the end of the leftmost first match, -1 if there is none, or -2 if the DFA gave up.
+int y_regex_dfa_find_end(y_regex* re, const unsigned char* text, int len, int start)
+{
+    y_regex_dfa* dfa = &re->forward;
+    int state, i;
+    int end = -1;
+
+    if( dfa->failed || (state = y_regex_dfa_start(re, dfa)) == Y_RE_UNKNOWN )
+        return -2;
+
+    for( i = start; ; i++ )
+    {
+        int next;
+        if( (dfa->state_flags[state] & Y_RE_STATE_MATCH) && (!dfa->anchored_end || i == len) )
+            end = i;
+        if( i == len )
+            break;
+        next = dfa->state_next[state][re->byte_class[text[i]]];
+        if( next == Y_RE_UNKNOWN && (next = y_regex_dfa_step(re, dfa, state, re->byte_class[text[i]])) == Y_RE_UNKNOWN )
+            return -2;
+        if( next == Y_RE_DEAD )
+            break;
+        state = next;
+    }
+    return end;
+}
+
+// Run the reverse DFA backwards from end. Returns the leftmost position >= limit where a match ending at end can start, or -2 if the DFA gave up.
+int y_regex_dfa_find_start(y_regex* re, const unsigned char* text, int limit, int end)
+{
+    y_regex_dfa* dfa = &re->reverse;
+    int state, i;
+    int start = -1;
+
+    if( dfa->failed || (state = y_regex_dfa_start(re, dfa)) == Y_RE_UNKNOWN )
+        return -2;
+
+    for( i = end; ; i-- )
+    {
+        int next;
+        if( dfa->state_flags[state] & Y_RE_STATE_MATCH )
+            start = i;
+        if( i == limit )
+            break;
+        next = dfa->state_next[state][re->byte_class[text[i -1]]];
+        if( next == Y_RE_UNKNOWN && (next = y_regex_dfa_step(re, dfa, state, re->byte_class[text[i -1]])) == Y_RE_UNKNOWN )
+            return -2;
+        if( next == Y_RE_DEAD )
+            break;
+        state = next;
+    }
+    return start;
+}
+
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// NFA simulation, for the capture groups.
+// ---------------------------------------------------------------------------------------------------------------------------
+
+// Add the threads reachable from pc without consuming input to thread list l, with re->caps as their captures.
+void y_regex_nfa_add(y_regex* re, int l, int* count, int pc, int pos)
+{
+    int slots = re->group_count * 2;
+    int top = 0;
+
+    // The stack holds (pc, slot, value) triples. A pc of -1 means: restore slot to value.
+    re->stack[top++] = pc;
+    re->stack[top++] = 0;
+    re->stack[top++] = 0;
+    while( top > 0 )
+    {
+        y_regex_inst* inst;
+        int value = re->stack[--top];
+        int slot = re->stack[--top];
+        pc = re->stack[--top];
+
+        if( pc < 0 )
+        {
+            re->caps[slot] = value;
+            continue;
+        }
+        if( re->mark[pc] == re->generation )
+            continue;
+        re->mark[pc] = re->generation;
+        inst = &re->prog[pc];
+
+        switch( inst->op )
+        {
+            case Y_RE_JMP:
+                re->stack[top++] = inst->x; re->stack[top++] = 0; re->stack[top++] = 0;
+                break;
+            case Y_RE_SPLIT:
+                re->stack[top++] = inst->y; re->stack[top++] = 0; re->stack[top++] = 0;
+                re->stack[top++] = inst->x; re->stack[top++] = 0; re->stack[top++] = 0;
+                break;
+            case Y_RE_SAVE:
+                re->stack[top++] = -1; re->stack[top++] = inst->x; re->stack[top++] = re->caps[inst->x];
+                re->caps[inst->x] = pos;
+                re->stack[top++] = pc +1; re->stack[top++] = 0; re->stack[top++] = 0;
+                break;
+            default:
+                re->thread_pcs[l][*count] = pc;
+                memcpy(re->thread_caps[l] + *count * slots, re->caps, slots * sizeof(int));
+                (*count)++;
+                break;
+        }
+    }
+}
+
+// Run the NFA simulation from start. Returns non-zero if a match was found; the capture slots are stored in caps.
+int y_regex_nfa_search(y_regex* re, const unsigned char* text, int len, int start, int anchored, int* caps)
+{
+    int slots = re->group_count * 2;
+    int cur = 0, count = 0;
+    int matched = 0;
+    int i, t;
+
+    for( i = 0; i < slots; i++ )
+        re->caps[i] = -1;
+    re->generation++;
+    y_regex_nfa_add(re, cur, &count, 0, start);
+
+    for( i = start; count > 0; i++ )
+    {
+        int next_count = 0;
+        re->generation++;
+
+        for( t = 0; t < count; t++ )
+        {
+            int pc = re->thread_pcs[cur][t];
+            y_regex_inst* inst = &re->prog[pc];
+
+            if( inst->op == Y_RE_MATCH )
+            {
+                if( re->anchored_end && i != len )
+                    continue;
+                memcpy(caps, re->thread_caps[cur] + t * slots, slots * sizeof(int));
+                matched = 1;
+                break; // lower priority threads lose
+            }
+            if( i < len && ((re->sets[inst->x * 32 + (text[i] >> 3)] >> (text[i] & 7)) & 1) )
+            {
+                memcpy(re->caps, re->thread_caps[cur] + t * slots, slots * sizeof(int));
+                y_regex_nfa_add(re, 1 - cur, &next_count, pc +1, i +1);
+            }
+        }
+        if( i == len )
+            break;
+        if( !matched && !anchored )
+        {
+            int j;
+            for( j = 0; j < slots; j++ )
+                re->caps[j] = -1;
+            y_regex_nfa_add(re, 1 - cur, &next_count, 0, i +1);
+        }
+        cur = 1 - cur;
+        count = next_count;
+    }
+    return matched;
+}
+//! \endcond
+
+
+// ---------------------------------------------------------------------------------------------------------------------------
+// Public interface
+// ---------------------------------------------------------------------------------------------------------------------------
+
+/*!
+\brief Compile a regular expression.
+
+Compiled patterns are cached for the rest of the test: compiling the same pattern again just returns the earlier result.
+See y_regex.c for the supported syntax.
+
+\param [in] pattern The regular expression.
+\returns The compiled pattern. If the pattern contains an error, this logs an error, calls lr_abort() and returns NULL.
+\sa y_regex_search(), y_regex_match(), y_regex_extract_all()
+*/
+y_regex* y_regex_compile(const char* pattern)
+{
+    y_regex* re;
+    const char* error = NULL;
+
+    for( re = _y_regexes; re != NULL; re = re->next )
+    {
+        if( strcmp(re->pattern, pattern) == 0 )
+            return re;
+    }
+
+    re = y_regex_compile_pattern(pattern, &error);
+    if( re == NULL )
+    {
+        lr_error_message("y_regex_compile(): Invalid regular expression \"%s\": %s", pattern, error);
+        lr_abort();
+        return NULL;
+    }
+    re->pattern = y_strdup((char*)pattern);
+    re->next = _y_regexes;
+    _y_regexes = re;
+    return re;
+}
+
+/*!
+\brief Search a piece of text for a compiled regular expression.
+
+This is the low level interface underneath y_regex_match() and y_regex_extract_all().
+It does not allocate any memory once the pattern has been used a few times. Binary safe.
+
+\param [in] re The compiled pattern, as returned by y_regex_compile().
+\param [in] text The text to search.
+\param [in] start The offset to start searching at.
+\param [out] captures Optional. If not NULL, receives the start and end offsets of each group: group N starts at captures[2*N]
+and ends at captures[2*N+1]. Group 0 is the entire match. Groups that did not participate in the match are -1.
+Must have room for 2 * re->group_count ints.
+\returns non-zero (true) if a match was found, zero (false) otherwise.
+\sa y_regex_compile(), y_regex_match()
+*/
+int y_regex_search(y_regex* re, y_strview text, int start, int* captures)
+{
+    const unsigned char* bytes = (const unsigned char*) text.ptr;
+    int len = text.len;
+    int match_start, match_end;
+    int scratch[Y_REGEX_MAX_GROUPS * 2];
+
+    if( captures == NULL )
+        captures = scratch;
+    if( start > len || (re->anchored_start && start > 0) )
+        return 0;
+
+    match_end = y_regex_dfa_find_end(re, bytes, len, start);
+    if( match_end == -1 )
+        return 0;
+    if( match_end >= 0 && captures == scratch )
+        return 1;
+
+    if( match_end >= 0 )
+    {
+        match_start = re->anchored_start ? start : y_regex_dfa_find_start(re, bytes, start, match_end);
+        if( match_start >= 0 )
+            return y_regex_nfa_search(re, bytes, len, match_start, 1, captures);
+    }
+
+    // The DFA ran out of states. Let the NFA do all of the work.
+    return y_regex_nfa_search(re, bytes, len, start, re->anchored_start, captures);
+}
+
+/*!
+\brief Search a parameter for a regular expression and save the first match into a parameter.
+
+If the pattern contains a capture group the text matched by the first group is saved, otherwise the text matched by the entire pattern.
+Use y_regex_match_groups() to get at all of the groups.
+
+\param [in] source_param The parameter to search.
+\param [in] pattern The regular expression. See y_regex.c for the supported syntax.
+\param [in] result_param The parameter to save the result in. If there is no match, it is not touched.
+\returns 1 if a match was found, 0 otherwise, or -1 if the pattern is invalid. An invalid pattern also logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("<input name=\"token\" value=\"a1b2c3\">", "Body");
+y_regex_match("Body", "name=\"token\" value=\"([^\"]*)\"", "Token");   // {Token} is now "a1b2c3"
+\endcode
+\sa y_regex_match_groups(), y_regex_extract_all(), y_substr()
+*/
+int y_regex_match(const char* source_param, const char* pattern, const char* result_param)
+{
+    y_regex* re = y_regex_compile(pattern);
+    int captures[Y_REGEX_MAX_GROUPS * 2];
+    int group;
+    int result;
+    y_arena_mark mark;
+    y_strview text;
+
+    if( re == NULL )
+        return -1;
+    group = re->group_count > 1 ? 1 : 0;
+    mark = y_arena_get_mark();
+    text = y_get_parameter_view(source_param);
+
+    if( text.ptr == NULL )
+    {
+        lr_error_message("y_regex_match(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    result = y_regex_search(re, text, 0, captures);
+    if( result )
+    {
+        if( captures[group * 2] < 0 )
+            lr_save_string("", result_param);
+        else
+            lr_save_var(text.ptr + captures[group * 2], captures[group * 2 +1] - captures[group * 2], 0, result_param);
+    }
+    y_arena_release(mark);
+    return result;
+}
+
+/*!
+\brief Search a parameter for a regular expression and save all groups of the first match into a parameter array.
+
+Group N is saved as element N of the array, so {result_array_1} holds the first capture group. The count is set to the number of
+capture groups in the pattern. Groups that did not participate in the match are saved as empty strings.
+
+\param [in] source_param The parameter to search.
+\param [in] pattern The regular expression. See y_regex.c for the supported syntax.
+\param [in] result_array The name of the parameter array to save the groups in. If there is no match, it is not touched.
+\returns 1 if a match was found, 0 otherwise, or -1 if the pattern is invalid. An invalid pattern also logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("Order 1234 placed on 2014-06-01", "Body");
+y_regex_match_groups("Body", "Order (\\d+) placed on (\\d+-\\d+-\\d+)", "Order");  // {Order_1} is "1234", {Order_2} is "2014-06-01"
+\endcode
+\sa y_regex_match(), y_regex_extract_all()
+*/
+int y_regex_match_groups(const char* source_param, const char* pattern, const char* result_array)
+{
+    y_regex* re = y_regex_compile(pattern);
+    int captures[Y_REGEX_MAX_GROUPS * 2];
+    int result, group;
+    y_arena_mark mark;
+    y_strview text;
+
+    if( re == NULL )
+        return -1;
+    mark = y_arena_get_mark();
+    text = y_get_parameter_view(source_param);
+
+    if( text.ptr == NULL )
+    {
+        lr_error_message("y_regex_match_groups(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    result = y_regex_search(re, text, 0, captures);
+    if( result )
+    {
+        for( group = 1; group < re->group_count; group++ )
+        {
+            y_arena_mark element_mark = y_arena_get_mark();
+            char* name = y_arena_array_element_name(result_array, group);
+            if( captures[group * 2] < 0 )
+                lr_save_string("", name);
+            else
+                lr_save_var(text.ptr + captures[group * 2], captures[group * 2 +1] - captures[group * 2], 0, name);
+            y_arena_release(element_mark);
+        }
+        y_array_save_count(re->group_count -1, result_array);
+    }
+    y_arena_release(mark);
+    return result;
+}
+
+/*!
+\brief Search a parameter for all matches of a regular expression and save them into a parameter array.
+
+This is the regular expression version of y_array_save_param_list(): the parameter is scanned once from start to end, and every
+match is saved as the next element of the result array. If the pattern contains a capture group the text matched by the first group
+is saved, otherwise the text matched by the entire pattern.
+
+\param [in] source_param The parameter to search.
+\param [in] pattern The regular expression. See y_regex.c for the supported syntax.
+\param [in] result_array The name of the parameter array to save the matches in.
+\returns The number of matches, or -1 if the pattern is invalid. An invalid pattern also logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("<option value=\"water\"><option value=\"fire\"><option value=\"burn\">", "SOURCE");
+y_regex_extract_all("SOURCE", "value=\"([^\"]*)\"", "VALUES");
+y_array_dump("VALUES");    // {VALUES_1} contains "water" (no quotes)    {VALUES_2} contains "fire" (no quotes)    etc...
+\endcode
+\sa y_regex_match(), y_array_save_param_list()
+*/
+int y_regex_extract_all(const char* source_param, const char* pattern, const char* result_array)
+{
+    y_regex* re = y_regex_compile(pattern);
+    int captures[Y_REGEX_MAX_GROUPS * 2];
+    int group;
+    int count = 0;
+    int pos = 0;
+    y_arena_mark mark;
+    y_strview text;
+
+    if( re == NULL )
+        return -1;
+    group = re->group_count > 1 ? 1 : 0;
+    mark = y_arena_get_mark();
+    text = y_get_parameter_view(source_param);
+
+    if( text.ptr == NULL )
+    {
+        lr_error_message("y_regex_extract_all(): Error: Parameter %s does not exist!", source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    while( pos <= (int)text.len && y_regex_search(re, text, pos, captures) )
+    {
+        y_arena_mark element_mark = y_arena_get_mark();
+        char* name = y_arena_array_element_name(result_array, ++count);
+        if( captures[group * 2] < 0 )
+            lr_save_string("", name);
+        else
+            lr_save_var(text.ptr + captures[group * 2], captures[group * 2 +1] - captures[group * 2], 0, name);
+        y_arena_release(element_mark);
+
+        // Continue after the match. Empty matches move on by one position to avoid matching the same spot forever.
+        pos = captures[1] > captures[0] ? captures[1] : captures[1] +1;
+    }
+    y_arena_release(mark);
+    y_array_save_count(count, result_array);
+    return count;
+}
+
+#endif // _Y_REGEX_C_
@@ -76,430 +76,1678 @@ lr_message("i = %d", i);  // result is "i = 9"
 //! \endcond
 
 /*!
-\brief Copy a parameter to a new name.
-This is a semi-efficiënt parameter copy using lr_eval_string_ext(), with appropriate freeing of memory.
-\param [in] source_param The parameter to copy.
-\param [in] dest_param The name of the parameter to copy the first parameter to.
-
-\b Example:
-\code
-lr_save_string("text", "param_a");
-y_copy_param("param_a", "param_b");   // Results in an exact copy of the content of param_a being stored in param_b.
-lr_log_message(lr_eval_string("param_b: {param_b}")); // Prints "param_b: text".
-\endcode
-\author Floris Kraak
-*/
-void y_copy_param(char* source_param, char* dest_param)
-{
-    char* buffer;
-    unsigned long size;
-    char* source = y_get_parameter_eval_string(source_param); // Puts the parameter name into parameter seperators { }.
-    lr_eval_string_ext(source, strlen(source), &buffer, &size, 0, 0, -1); // Evaluates the result and copy the data into buffer.
-    free(source);                              // Free the intermediate parameter name.
-    lr_save_var(buffer, size, 0, dest_param);  // Save the result.
-    lr_eval_string_ext_free(&buffer);          // Free the buffer.
-}
+\brief Search for a block of memory inside another block of memory. Binary safe.
 
-/*!
-\brief Convert the content of a parameter to UPPERCASE. 
+This is the search kernel behind all of ylib's boundary based extraction functions. Unlike strstr() it does not need a '\0' byte at
+the end of either argument and it does not stop at embedded null bytes.
 
-This will replace the content of the paramenter named in 'param_name' with the uppercased version.
-Does not affect non-alphabetic characters.
+Candidate positions are found with memchr() on the first byte of the needle, which the C runtime implements with wide loads.
+Before the rest of the needle is compared the last byte is checked, which throws out nearly all false candidates in typical
+HTML and JSON responses (where the first byte is often something common like '<' or '"') without calling memcmp().
 
-\param [in] param_name The parameter to convert to uppercase.
+\param [in] haystack The memory to search.
+\param [in] haystack_len The length of the memory to search.
+\param [in] needle The text to look for.
+\param [in] needle_len The length of the text to look for.
+\returns A pointer to the first match, or NULL if there is no match. An empty needle matches at the start of the haystack.
 
 \b Example:
 \code
-lr_save_string("aBcDeFgHiJ &*45#$@#)!({}", "Test");
-lr_message(lr_eval_string("Original: {Test}\n"));
-y_uppercase_parameter("Test");
-lr_message(lr_eval_string("Altered: {Test}\n")); // prints "Altered: ABCDEFGHIJ &*45#$@#)!({}".
+char* html = "<div class=\"a\"><span>";
+char* match = y_find(html, strlen(html), "<span", 5); // Points to "<span>"
 \endcode
-\author Floris Kraak
+\sa y_strview_find()
 */
-void y_uppercase_parameter(const char* param_name)
+char* y_find(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
 {
-    char *result = y_get_parameter_or_null(param_name);
-    if(result == NULL)
+    const char *p = haystack;
+    const char *end;
+    char first, last;
+
+    if( needle_len == 0 )
     {
-        lr_error_message("Nonexistant parameter %s passed to y_uppercase_parameter(): Aborting.", param_name);
-        lr_abort();
+        return (char*) haystack;
+    }
+    if( needle_len > haystack_len )
+    {
+        return NULL;
     }
-    strupr(result);
-    lr_save_string(result, param_name);
-}
-
-/*!
-\brief Save a substring of a parameter into a new parameter.
-Search for a specific substring inside a parameter using left and right boundaries and save that into a new parameter.
 
-\param [in] original_parameter The parameter to search.
-\param [in] result_parameter The name of the parameter to store the result in.
-\param [in] left The left boundary - the text immediately preceding the substring in question.
-\param [in] right The right boundary.
+    first = needle[0];
+    last = needle[needle_len -1];
+    end = haystack + haystack_len - needle_len +1; // the last position a match can start at, +1
 
-\b Example:
-\code
-char* str = "LorumIpsumLipsum";
-lr_save_string(str, "param");
-y_substr("param", "param", "Lorum", "Lipsum");
-lr_log_message(lr_eval_string("{param}")); // Prints "Ipsum".
-\endcode
-\author André Luyer, Marcel Jepma & Floris Kraak
-*/
-void y_substr(const char *original_parameter, const char *result_parameter, const char *left, const char *right)
-{
-    char *p1;
-    char *str = y_get_parameter_or_null(original_parameter);
-    if( str == NULL )
+    while( p < end && (p = (const char*) memchr(p, first, end - p)) != NULL )
     {
-        lr_error_message("y_substr(): Error: Parameter %s does not exist!", original_parameter);
-        lr_abort();
+        if( p[needle_len -1] == last && memcmp(p +1, needle +1, needle_len -1) == 0 )
+        {
+            return (char*) p;
+        }
+        p++;
     }
+    return NULL;
+}
 
-    // zoek start
-    if (left) {
-        p1 = strstr(str, left);
-        if (p1) str = p1 + strlen(left);
-        // else start is positie 0...
-    }
+//! \cond internal_functions
+// ASCII-only case insensitive comparison of two blocks of memory of the same length. Returns non-zero if they are equal.
+int y_memequal_i(const char* a, const char* b, size_t len)
+{
+    size_t i;
 
-    // zoek eind
-    if (right) {
-        p1 = strstr(str, right);
-        if (p1) {
-            lr_param_sprintf(result_parameter, "%.*s", p1 - str, str); // of sprintf
-            return;
+    for( i = 0; i < len; i++ )
+    {
+        unsigned char ca = a[i];
+        unsigned char cb = b[i];
+        if( ca != cb && ((ca | 0x20) != (cb | 0x20) || (ca | 0x20) < 'a' || (ca | 0x20) > 'z') )
+        {
+            return 0;
         }
     }
-    lr_save_string(str, result_parameter);
+    return 1;
 }
-
+//! \endcond
 
 /*!
-\brief Split a string into 2 parts using the search string. Save the left part into the result parameter.
-\param [in] original_parameter The parameter to search.
-\param [in] search The text after the text we're looking for.
-\param [in] result_parameter The name of the parameter to store the result in.
+\brief Search for a block of memory inside another block of memory, ignoring differences in case. Binary safe.
+
+Case insensitive version of y_find(). Only the ASCII letters A-Z are folded, and they are folded on the fly while searching,
+so there is no need to make a lowercased copy of the haystack first.
+
+Candidate positions are found with memchr() on both the upper and lower case form of the first byte of the needle.
+The next occurrence of each is remembered, so neither part of the haystack is scanned twice.
+
+\param [in] haystack The memory to search.
+\param [in] haystack_len The length of the memory to search.
+\param [in] needle The text to look for.
+\param [in] needle_len The length of the text to look for.
+\returns A pointer to the first match, or NULL if there is no match. An empty needle matches at the start of the haystack.
 
 \b Example:
 \code
-lr_save_string("AstrixObelixIdefix", "Test");
-lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}=AstrixObelixIdefix
-y_left( "Test", "Obelix", "Test2" );
-lr_message(lr_eval_string("New Param: {Test2}\n"));    // {Test2}=Astrix
+char* html = "<DIV CLASS=\"a\"><SPAN>";
+char* match = y_find_i(html, strlen(html), "<span", 5); // Points to "<SPAN>"
 \endcode
-\author Floris Kraak
+\sa y_find(), y_strview_find_i()
 */
-void y_left( const char *original_parameter, const char *search, const char *result_parameter )
+char* y_find_i(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
 {
-    char *original = y_get_parameter_or_null(original_parameter);
-    if( original == NULL )
+    const char *p = haystack;
+    const char *end;
+    const char *next_lower;
+    const char *next_upper;
+    char lower, upper;
+
+    if( needle_len == 0 )
     {
-        lr_error_message("y_left(): Error: Parameter %s does not exist!", original_parameter);
-        lr_abort();
+        return (char*) haystack;
     }
-    else if( search == NULL || strlen(search) == 0 )
+    if( needle_len > haystack_len )
     {
-        lr_save_string(original, result_parameter);
-        lr_log_message("Warning: Empty search parameter passed to y_left()");
-        return;
+        return NULL;
     }
-    else
-    {
-        char *buffer;
-        char *posPtr = (char *)strstr(original, search);
-        int pos = (int)(posPtr - original);
-        //lr_log_message("y_left: original=%s, search=%s, resultParam=%s", original, search, resultParam);
 
-        if( posPtr == NULL )
+    lower = upper = needle[0];
+    if( lower >= 'A' && lower <= 'Z' )
+        lower |= 0x20;
+    if( upper >= 'a' && upper <= 'z' )
+        upper &= ~0x20;
+    end = haystack + haystack_len - needle_len +1; // the last position a match can start at, +1
+
+    if( lower == upper )
+    {
+        // The first byte is not a letter: search for it as is.
+        while( p < end && (p = (const char*) memchr(p, lower, end - p)) != NULL )
         {
-            lr_save_string(original, result_parameter);
-            return;
+            if( y_memequal_i(p +1, needle +1, needle_len -1) )
+            {
+                return (char*) p;
+            }
+            p++;
         }
-        //lr_log_message("pos = %d", pos);
+        return NULL;
+    }
 
-        // Copy the original to a temporary buffer
-        buffer = y_strdup(original);
-        buffer[pos] = '\0'; // make the cut
-        lr_save_string(buffer, result_parameter); // save the result
-        free(buffer);
+    next_lower = (const char*) memchr(p, lower, end - p);
+    next_upper = (const char*) memchr(p, upper, end - p);
+    while( next_lower != NULL || next_upper != NULL )
+    {
+        // Take whichever comes first, and look for the next one of that case.
+        if( next_upper == NULL || (next_lower != NULL && next_lower < next_upper) )
+        {
+            p = next_lower;
+            next_lower = p +1 < end ? (const char*) memchr(p +1, lower, end - p -1) : NULL;
+        }
+        else
+        {
+            p = next_upper;
+            next_upper = p +1 < end ? (const char*) memchr(p +1, upper, end - p -1) : NULL;
+        }
+        if( y_memequal_i(p +1, needle +1, needle_len -1) )
+        {
+            return (char*) p;
+        }
     }
+    return NULL;
 }
 
-
 /*!
-\brief Split a string into 2 parts using the search string. Save the right part into the result parameter.
-\param [in] original_parameter The parameter to search.
-\param [in] search The text preceding the text we're looking for.
-\param [in] result_parameter The name of the parameter to store the result in.
+\brief Search for the last occurrence of a block of memory inside another block of memory. Binary safe.
+
+The reverse counterpart of y_find(), in the spirit of the GNU memrmem(): the haystack is scanned from the end towards the start,
+so finding the last match costs only as much as the distance from the end to that match. The last byte of the needle is compared before
+the rest, which throws out nearly all false candidates without calling memcmp().
+
+\param [in] haystack The memory to search.
+\param [in] haystack_len The length of the memory to search.
+\param [in] needle The text to look for.
+\param [in] needle_len The length of the text to look for.
+\returns A pointer to the last match, or NULL if there is no match. An empty needle matches at the end of the haystack.
 
 \b Example:
 \code
-lr_save_string("AstrixObelixIdefix", "Test");
-lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}=AstrixObelixIdefix
-y_right( "Test", "Obelix", "Test4" );
-lr_message(lr_eval_string("New Param: {Test4}\n"));    //    {Test4}=Idefix
+char* path = "/a/b/c.html";
+char* match = y_rfind(path, strlen(path), "/", 1); // Points to "/c.html"
 \endcode
-\author Floris Kraak
+\sa y_find(), y_strview_rfind()
 */
-void y_right( const char *original_parameter, const char *search, const char *result_parameter)
+char* y_rfind(const char* haystack, size_t haystack_len, const char* needle, size_t needle_len)
 {
-    char* original = y_get_parameter_or_null(original_parameter);
-    if( original == NULL )
+    const char *p;
+    size_t offset;
+    char first, last;
+
+    if( needle_len == 0 )
     {
-        lr_error_message("y_right(): Error: Parameter %s does not exist!", original_parameter);
-        lr_abort();
+        return (char*) haystack + haystack_len;
     }
-    else if( search == NULL || strlen(search) == 0 )
+    if( needle_len > haystack_len )
     {
-        lr_save_string(original, result_parameter);
-        lr_log_message("Warning: Empty search parameter passed to y_right()");
-        return;
+        return NULL;
     }
-    else
+
+    first = needle[0];
+    last = needle[needle_len -1];
+    // Count the offset down instead of the pointer: a pointer below the start of the haystack is undefined behaviour.
+    offset = haystack_len - needle_len +1;
+    while( offset-- > 0 )
     {
-        char* posPtr = (char *)strstr(original, search);
-        //int pos = (int)(posPtr - original);
-        //lr_log_message("y_right: original=%s, search=%s, resultParam=%s", original, search, result_parameter);
-    
-        if( posPtr == NULL )
+        p = haystack + offset;
+        if( p[needle_len -1] == last && *p == first && memcmp(p +1, needle +1, needle_len -1) == 0 )
         {
-            lr_save_string(original, result_parameter);
-            return;
+            return (char*) p;
         }
-        //lr_log_message("pos = %d", pos);
-        posPtr = posPtr + strlen(search);
-        lr_save_string(posPtr, result_parameter);
     }
+    return NULL;
 }
 
+/*! \brief A length-aware view on a piece of memory, usually (part of) the content of a parameter.
+
+A view does not own the memory it points to. It carries it's own length, so it does not need a '\0' byte at the end
+and may contain embedded null bytes. Taking a slice out of a view is free - no copying, no strlen().
+
+\sa y_strview_from_string(), y_get_parameter_view(), y_save_view()
+*/
+struct y_struct_strview
+{
+    //! Start of the data.
+    const char* ptr;
+    //! Length of the data, in bytes.
+    size_t len;
+};
+//! \brief A length-aware view on a piece of memory. \sa y_struct_strview
+typedef struct y_struct_strview y_strview;
 
 /*!
-\brief Split a string into 2 parts using the search string. Save the rightmost part into the result parameter.
-This is almost the same as y_right(), but doesn't stop at the first match - instead, it uses the *last* match.
-It's pretty much the difference between 'greedy' and 'not greedy' in a regular expression..
+\brief Create a view on a block of memory.
+\param [in] ptr Start of the data.
+\param [in] len Length of the data.
+\returns The view.
+*/
+y_strview y_strview_make(const char* ptr, size_t len)
+{
+    y_strview view;
+    view.ptr = ptr;
+    view.len = len;
+    return view;
+}
 
-\param [in] original_parameter The parameter to search.
-\param [in] search The text preceding the text we're looking for.
-\param [in] result_parameter The name of the parameter to store the result in.
+/*!
+\brief Create a view on a '\0' terminated string.
+\param [in] str The string. NULL results in an empty view.
+\returns The view.
+*/
+y_strview y_strview_from_string(const char* str)
+{
+    return y_strview_make(str, str ? strlen(str) : 0);
+}
+
+/*!
+\brief Get a view on the content of a parameter. Binary safe.
+
+The parameter is evaluated with lr_eval_string_ext() so embedded null bytes are preserved. The buffer holding the content is owned by the arena,
+so it is freed when the caller releases it's arena mark.
+\param [in] param_name The name of the parameter.
+\returns A view on the content of the parameter. If the parameter does not exist, the ptr member of the view is NULL.
+\warning The view remains valid until the ylib arena is released past the point where this was called, or reset. Take an arena mark before calling this, and release it when done with the view.
 
 \b Example:
 \code
-lr_save_string("AstrixObelixIdefix", "Test");
-lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}=AstrixObelixIdefix
-y_right( "Test", "Obelix", "Test4" );
-lr_message(lr_eval_string("New Param: {Test4}\n"));    //    {Test4}=Idefix
+y_arena_mark mark = y_arena_get_mark();
+y_strview page = y_get_parameter_view("Page");
+if( page.ptr != NULL )
+    lr_message("The page is %d bytes long", page.len);
+y_arena_release(mark);    // The view is gone now.
 \endcode
-\author Floris Kraak
+\sa y_save_view(), y_arena_get_mark(), y_arena_adopt_eval_buffer()
 */
-void y_last_right( const char *original_parameter, const char *search, const char *result_parameter)
+y_strview y_get_parameter_view(const char* param_name)
 {
-    char *result = y_get_parameter_or_null(original_parameter);
-    if( result == NULL )
-    {
-        lr_error_message("y_last_right(): Error: Parameter %s does not exist!", original_parameter);
-        lr_abort();
-    }
-    else if( search == NULL || strlen(search) == 0 )
-    {
-        lr_save_string(result, result_parameter);
-        lr_log_message("Warning: Empty search parameter passed to y_last_right()");
-        return;
-    }
-    else
+    size_t source_len;
+    const char* source = y_get_interned_eval_string(param_name, &source_len);
+    unsigned long size;
+    char* buffer;
+
+    lr_eval_string_ext(source, source_len, &buffer, &size, 0, 0, -1);
+    // If the parameter doesn't exist lr_eval_string_ext() hands back the eval string itself.
+    // This is checked on every call, as the parameter may have been freed with lr_free_parameter() since the last one.
+    if( size == source_len && memcmp(buffer, source, size) == 0 )
     {
-        char *posPtr;
-        //lr_log_message("y_last_right: original=%s, search=%s, resultParam=%s", original, search, resultParameter);
-        do 
-        {
-            posPtr = (char *)strstr(result, search);
-            //pos = (int)(posPtr - result);
-            //lr_log_message("pos = %d", pos);
-    
-            // not found, save what we have as the result.
-            if( posPtr == NULL )
-            {
-                lr_save_string(result, result_parameter);
-                return;
-            }
-            // found, update the result pointer and go find more..
-            result = posPtr + strlen(search);
-        } 
-        while(1);
+        lr_eval_string_ext_free(&buffer);
+        return y_strview_make(NULL, 0);
     }
+    return y_strview_make(y_arena_adopt_eval_buffer(buffer), size);
 }
 
-
 /*!
-\brief Split a string into 2 parts based on a search string
+\brief Save the content of a view into a parameter. Binary safe.
+\param [in] view The data to save.
+\param [in] param_name The name of the parameter to save it in.
+\sa y_get_parameter_view(), lr_save_var()
+*/
+void y_save_view(y_strview view, const char* param_name)
+{
+    lr_save_var(view.len ? view.ptr : "", view.len, 0, param_name);
+}
 
-\warning Unlike the others this one does not use parameter, but raw char pointers instead.
-This mostly to accomodate y_array_split().
-For the parameter version use y_split().
+/*!
+\brief Search for a piece of text inside a view.
+\param [in] haystack The view to search.
+\param [in] needle The text to look for.
+\returns The offset of the first match, or -1 if there is no match. An empty needle matches at offset 0.
+\sa y_find()
+*/
+int y_strview_find(y_strview haystack, y_strview needle)
+{
+    const char* match = y_find(haystack.ptr, haystack.len, needle.ptr, needle.len);
+    return match ? match - haystack.ptr : -1;
+}
 
-\param [in] original The string to search.
-\param [in] separator The string to use as a seperation marker between the two parts.
-\param [in] left A preallocated char* buffer to hold the left hand side of the result.
-\param [in] right A preallocated char* buffer to hold the right hand side of the result.
-\author Floris Kraak
+/*!
+\brief Search for a piece of text inside a view, ignoring differences in case.
+\param [in] haystack The view to search.
+\param [in] needle The text to look for.
+\returns The offset of the first match, or -1 if there is no match. An empty needle matches at offset 0.
+\sa y_find_i(), y_strview_find()
 */
-void y_split_str( const char *original, const char *separator, char *left, char *right)
+int y_strview_find_i(y_strview haystack, y_strview needle)
 {
-    char *buffer;
-    char *posPtr = (char *)strstr(original, separator);
-    int pos = (int)(posPtr - original);;
+    const char* match = y_find_i(haystack.ptr, haystack.len, needle.ptr, needle.len);
+    return match ? match - haystack.ptr : -1;
+}
 
-    //lr_log_message("y_split_str: original=%s, search=%s", original, search);
+/*!
+\brief Search for the last occurrence of a piece of text inside a view.
+\param [in] haystack The view to search.
+\param [in] needle The text to look for.
+\returns The offset of the last match, or -1 if there is no match. An empty needle matches at the end of the view.
+\sa y_rfind(), y_strview_find()
+*/
+int y_strview_rfind(y_strview haystack, y_strview needle)
+{
+    const char* match = y_rfind(haystack.ptr, haystack.len, needle.ptr, needle.len);
+    return match ? match - haystack.ptr : -1;
+}
 
-    if( posPtr == NULL )
+/*!
+\brief Take a slice out of a view.
+Out of range values are clamped to the end of the view.
+\param [in] view The view.
+\param [in] start The offset to start at.
+\param [in] len The length of the slice.
+\returns The slice.
+*/
+y_strview y_strview_slice(y_strview view, size_t start, size_t len)
+{
+    if( start > view.len )
     {
-        // Copy the original to the left hand output buffer.
-        strncpy(left, original, strlen(original)+1); // Let's not forget to copy the null byte, too.
-        return;
+        start = view.len;
     }
-    //lr_log_message("pos = %d", pos);
-
-    // Copy the left hand using pos bytes from the original
-    strncpy(left, original, pos);
-    left[pos] = '\0'; // make the cut by putting a null character at the end.
-
-    // Copy the right hand side starting from the position just after the found string.
+    if( len > view.len - start )
     {
-        char *start = posPtr + strlen(separator);
-        strncpy(right, start, strlen(start)+1); // Let's not forget to copy the null byte, too.
+        len = view.len - start;
     }
+    return y_strview_make(view.ptr + start, len);
 }
 
-
 /*!
-\brief Split a parameter in two based on a seperating string.
-If the seperator is not found in the original parameter the original parameter will be stored in it's entirety in the left hand parameter.
-
-\param [in] originalParameter The parameter to search.
-\param [in] separator The string to use as a seperation marker between the two parts.
-\param [in] leftParameter The parameter that will hold the left hand side of the split result.
-\param [in] rightParameter The parameter that will hold the right hand side of the split result.
-
-\b Example:
-\code
-lr_save_string("WackoYackoDotWarner", "Test");
-lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}    = WackoYackoDotWarner
-y_split("Test", "Yacko", "Left", "Right");           // Use "Yacko" as the separator
-lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}    = WackoYackoDotWarner
-lr_message(lr_eval_string("Left    : {Left}\n"));    // {Left}    = Wacko
-lr_message(lr_eval_string("Right   : {Right}\n"));   // {Right}   = DotWarner
-\endcode
-\author Floris Kraak
+\brief Remove leading and trailing whitespace from a view.
+Whitespace is " ", "\r", "\n" and "\t", as with y_chop().
+\param [in] view The view.
+\returns The trimmed view.
 */
-void y_split( const char *originalParameter, const char *separator, const char *leftParameter, const char *rightParameter)
+y_strview y_strview_trim(y_strview view)
 {
-    char *item = y_get_parameter(originalParameter);
-    int len = strlen(item);
+    const char* start = view.ptr;
+    const char* end = view.ptr + view.len;
 
-    if( len < strlen(separator) )
+    while( start < end && (*start == ' ' || *start == '\r' || *start == '\n' || *start == '\t') )
     {
-        // Since the separator doesn't even fit in the item, searching is pointless.
-        // Store the original in the left hand parameter, the right hand is empty.
-        lr_save_string(originalParameter, leftParameter);
-        lr_save_string("", rightParameter);
-        return;
-
+        start++;
     }
-    else
+    while( end > start && (end[-1] == ' ' || end[-1] == '\r' || end[-1] == '\n' || end[-1] == '\t') )
     {
-
-        // Left hand side
-        // If the separator isn't found the full original string gets stored here.
-        // Don't forget the 0 byte at the end though..
-        char *left = y_mem_alloc(len+1);
-
-        // Right hand side
-        // If the separator gets found in position 1 the remainder of the
-        // original string gets stored here (and left gets a zero-length string).
-        char *right = y_mem_alloc(len-strlen(separator)+1);
-
-        // Start off with zero-length strings. We can safely assume
-        // both variables contain garbage when freshly allocated.
-        left[0] = '\0';
-        right[0] = '\0';
-
-        // This is where the magic happens.
-        y_split_str(item, separator, left, right);
-
-        // Store the results in parameters.
-        lr_save_string(left, leftParameter);
-        free(left);
-        lr_save_string(right, rightParameter);
-        free(right);
+        end--;
     }
+    return y_strview_make(start, end - start);
 }
 
+/*!
+\brief Compare two views.
+\param [in] a The first view.
+\param [in] b The second view.
+\returns Less than, equal to or greater than zero, like memcmp(). A view that is a prefix of the other sorts first.
+*/
+int y_strview_compare(y_strview a, y_strview b)
+{
+    size_t len = a.len < b.len ? a.len : b.len;
+    int result = len ? memcmp(a.ptr, b.ptr, len) : 0;
+    if( result != 0 )
+    {
+        return result;
+    }
+    return a.len < b.len ? -1 : (a.len > b.len);
+}
 
 /*!
-\brief Remove leading and trailing whitespace from a parameter.
+\brief Test if two views have the same content.
+\param [in] a The first view.
+\param [in] b The second view.
+\returns non-zero (true) if the views are equal, zero (false) otherwise.
+*/
+int y_strview_equals(y_strview a, y_strview b)
+{
+    return a.len == b.len && (a.len == 0 || memcmp(a.ptr, b.ptr, a.len) == 0);
+}
 
-This does not support unicode, so it may not catch everything.
-Supported whitespace is: 
-  " "(=space)
-  "\r"(=carrige return)
-  "\n"(=line feed)
-  "\t"(=tab)
-The result is stored in the original parameter.
+/*!
+\brief Test if a view starts with a given prefix.
+\param [in] view The view.
+\param [in] prefix The prefix.
+\returns non-zero (true) if the view starts with the prefix, zero (false) otherwise.
+*/
+int y_strview_starts_with(y_strview view, y_strview prefix)
+{
+    return prefix.len <= view.len && (prefix.len == 0 || memcmp(view.ptr, prefix.ptr, prefix.len) == 0);
+}
 
-\param [in] parameter The parameter to chop.
 
-\b Example:
-\code
-lr_save_string("  WackoYackoDot ", "Test");
-lr_message(lr_eval_string("Original: >{Test}<\n"));    // {Test}= "  WackoYackoDot "
-y_chop("Test");
-lr_message(lr_eval_string("Original: >{Test}<\n"));    // {Test}= "WackoYackoDot"
-\endcode
-\author: Floris Kraak
+/*!
+\brief Take the text between a left and right boundary out of a view.
+View version of y_substr().
+\param [in] original The view to search.
+\param [in] left The left boundary. If it's ptr is NULL or it is not found, the result starts at the start of the original.
+\param [in] right The right boundary. If it's ptr is NULL or it is not found, the result runs to the end of the original.
+\returns The text between the boundaries, as a view on the original.
+\sa y_substr()
 */
-void y_chop( const char* parameter )
+y_strview y_substr_view(y_strview original, y_strview left, y_strview right)
 {
-    char *result;
-    int i = 0;
-    char character;
-    
-    //lr_output_message( "y_chop(%s)", parameter);    
-    result = y_get_parameter(parameter);
+    int pos;
 
-    // y_chop leading whitespace
-    character = result[i];
-    while( (character == ' ') || (character == '\r') || (character == '\n') || (character == '\t') )
+    if( left.ptr != NULL && (pos = y_strview_find(original, left)) >= 0 )
     {
-        character = result[++i];
+        original = y_strview_slice(original, pos + left.len, original.len);
     }
-    result += i;
-    
-    //lr_output_message("result after removal of leading whitespace: %s", result);
-    
-    // y_chop trailing whitespace
-    i = strlen(result)-1;    
-    character = result[i];
-    while( (i >= 0) &&
-           (  (character == ' ' ) ||
-              (character == '\r') ||
-              (character == '\n') ||
-              (character == '\t') ) )
+    if( right.ptr != NULL && (pos = y_strview_find(original, right)) >= 0 )
     {
-        character = result[--i];
+        original.len = pos;
     }
-    result[i+1] = '\0';
-    
-    lr_save_string(result, parameter);
+    return original;
 }
 
-
 /*!
-\brief Search and replace inside a parameter.
+\brief Find the Nth piece of text between two boundaries in a view.
+View version of y_substr_nth(). Counting forward, a match is the first right boundary after a left boundary, and the search for the next match
+continues after that right boundary. Counting backward (negative n), a match is the last left boundary before a right boundary,
+and the search continues before that left boundary. The search stops as soon as the requested match is found.
+\param [in] original The view to search.
+\param [in] left The left boundary. Must not be empty.
+\param [in] right The right boundary. Must not be empty.
+\param [in] n Which match: 1 for the first, 2 for the second, and so on. -1 for the last, -2 for the one before that, and so on.
+\param [out] result Receives the text between the boundaries of the match, as a view on the original.
+\returns non-zero (true) if the match exists, zero (false) otherwise.
+\sa y_substr_nth(), y_rfind()
+*/
+int y_substr_nth_view(y_strview original, y_strview left, y_strview right, int n, y_strview* result)
+{
+    y_strview rest = original;
+    int pos;
+
+    if( left.len == 0 || right.len == 0 || n == 0 )
+    {
+        return 0;
+    }
+
+    if( n > 0 )
+    {
+        for(;;)
+        {
+            if( (pos = y_strview_find(rest, left)) < 0 )
+                return 0;
+            rest = y_strview_slice(rest, pos + left.len, rest.len);
+            if( (pos = y_strview_find(rest, right)) < 0 )
+                return 0;
+            if( --n == 0 )
+            {
+                *result = y_strview_slice(rest, 0, pos);
+                return 1;
+            }
+            rest = y_strview_slice(rest, pos + right.len, rest.len);
+        }
+    }
+
+    for(;;)
+    {
+        int start;
+        if( (pos = y_strview_rfind(rest, right)) < 0 )
+            return 0;
+        rest.len = pos;
+        if( (start = y_strview_rfind(rest, left)) < 0 )
+            return 0;
+        if( ++n == 0 )
+        {
+            *result = y_strview_slice(rest, start + left.len, rest.len);
+            return 1;
+        }
+        rest.len = start;
+    }
+}
+
+/*!
+\brief Take the text before the first occurrence of a search string out of a view.
+View version of y_left().
+\param [in] original The view to search.
+\param [in] search The text to search for.
+\returns The text before the match. If there is no match or the search string is empty, the original.
+\sa y_left()
+*/
+y_strview y_left_view(y_strview original, y_strview search)
+{
+    int pos = search.len ? y_strview_find(original, search) : -1;
+    if( pos >= 0 )
+    {
+        original.len = pos;
+    }
+    return original;
+}
+
+/*!
+\brief Take the text after the first occurrence of a search string out of a view.
+View version of y_right().
+\param [in] original The view to search.
+\param [in] search The text to search for.
+\returns The text after the match. If there is no match or the search string is empty, the original.
+\sa y_right()
+*/
+y_strview y_right_view(y_strview original, y_strview search)
+{
+    int pos = search.len ? y_strview_find(original, search) : -1;
+    if( pos >= 0 )
+    {
+        return y_strview_slice(original, pos + search.len, original.len);
+    }
+    return original;
+}
+
+/*!
+\brief Take the text after the last occurrence of a search string out of a view.
+View version of y_last_right(). The view is searched from the end, so only the part after the last match is scanned.
+\param [in] original The view to search.
+\param [in] search The text to search for.
+\returns The text after the last match. If there is no match or the search string is empty, the original.
+\sa y_last_right(), y_rfind()
+*/
+y_strview y_last_right_view(y_strview original, y_strview search)
+{
+    int pos = search.len ? y_strview_rfind(original, search) : -1;
+    if( pos >= 0 )
+    {
+        return y_strview_slice(original, pos + search.len, original.len);
+    }
+    return original;
+}
+
+/*!
+\brief Split a view in two around the first occurrence of a separator.
+View version of y_split().
+\param [in] original The view to split.
+\param [in] separator The separator.
+\param [out] left Receives the text before the separator, or the original if the separator is not found.
+\param [out] right Receives the text after the separator, or an empty view if the separator is not found.
+\returns non-zero (true) if the separator was found, zero (false) otherwise.
+\sa y_split()
+*/
+int y_split_view(y_strview original, y_strview separator, y_strview* left, y_strview* right)
+{
+    int pos = y_strview_find(original, separator);
+
+    if( pos < 0 )
+    {
+        *left = original;
+        *right = y_strview_slice(original, original.len, 0);
+        return 0;
+    }
+    *left = y_strview_slice(original, 0, pos);
+    *right = y_strview_slice(original, pos + separator.len, original.len);
+    return 1;
+}
+
+/*! \brief An iterator over the lines or tokens of a parameter (or view), as returned by y_lines_begin() and y_tokens_begin().
+
+The iterator holds one binary safe copy of the parameter content, made by lr_eval_string_ext(). Walking it hands out views on that copy,
+so no parameters are created and nothing is allocated per line or token.
+\sa y_lines_begin(), y_tokens_begin(), y_tokens_next(), y_tokens_end()
+*/
+struct y_struct_tokenizer
+{
+    //! The text being walked.
+    y_strview text;
+    //! The offset of the next token in the text.
+    size_t pos;
+    //! The delimiter between tokens.
+    y_strview delimiter;
+    //! Non-zero for line iterators: a '\r' at the end of a line is not part of the line, and there is no empty line after a final newline.
+    int lines;
+    //! Non-zero once the last token has been handed out.
+    int done;
+    //! The copy of the parameter content, or NULL if the iterator walks a view owned by someone else.
+    char* buffer;
+};
+//! \brief An iterator over the lines or tokens of a parameter. \sa y_struct_tokenizer
+typedef struct y_struct_tokenizer y_tokenizer;
+
+//! \cond internal_functions
+// Set up an iterator over a parameter. If the parameter doesn't exist the iterator is empty.
+y_tokenizer y_tokenizer_begin(const char* function_name, const char* param_name, y_strview delimiter, int lines)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    char* source = y_arena_get_parameter_eval_string(param_name);
+    size_t source_len = strlen(source);
+    unsigned long size = 0;
+    y_tokenizer it;
+
+    memset(&it, 0, sizeof(it));
+    it.delimiter = delimiter;
+    it.lines = lines;
+
+    lr_eval_string_ext(source, source_len, &it.buffer, &size, 0, 0, -1);
+    if( size == source_len && memcmp(it.buffer, source, size) == 0 )
+    {
+        lr_error_message("%s(): Error: Parameter %s does not exist!", function_name, param_name);
+        lr_eval_string_ext_free(&it.buffer);
+        it.buffer = NULL;
+        it.done = 1;
+        y_arena_release(mark);
+        lr_abort();
+        return it;
+    }
+    y_arena_release(mark);
+
+    it.text = y_strview_make(it.buffer, size);
+    it.done = (size == 0);
+    return it;
+}
+//! \endcond
+
+/*!
+\brief Start walking the lines of a parameter.
+
+Lines end in "\n" or "\r\n". The line ends are not part of the lines, and a newline at the very end does not start another (empty) line.
+Binary safe. The parameter itself is not modified, and can be changed or freed while the iterator is in use.
+
+\param [in] param_name The parameter to walk.
+\returns The iterator. Pass it to y_lines_next() to get the lines, and to y_lines_end() when done.
+If the parameter does not exist this logs an error and calls lr_abort(); the iterator is empty.
+
+\b Example:
+\code
+y_tokenizer lines = y_lines_begin("Export");
+y_strview line;
+while( y_lines_next(&lines, &line) )
+{
+    if( y_strview_starts_with(line, y_strview_from_string("ERROR")) )
+        lr_error_message("%.*s", line.len, line.ptr);
+}
+y_lines_end(&lines);
+\endcode
+\sa y_lines_next(), y_lines_end(), y_tokens_begin()
+*/
+y_tokenizer y_lines_begin(const char* param_name)
+{
+    return y_tokenizer_begin("y_lines_begin", param_name, y_strview_make("\n", 1), 1);
+}
+
+/*!
+\brief Start walking the tokens of a parameter, separated by a delimiter.
+
+Every occurrence of the delimiter separates two tokens, so tokens can be empty: "a,,b" gives "a", "" and "b", and "a,b," gives "a", "b" and "".
+An empty parameter has no tokens at all. Binary safe. The parameter itself is not modified.
+
+\param [in] param_name The parameter to walk.
+\param [in] delimiter The text between two tokens. Must not be empty. Not copied, so it must remain valid while the iterator is in use.
+\returns The iterator. Pass it to y_tokens_next() to get the tokens, and to y_tokens_end() when done.
+If the parameter does not exist this logs an error and calls lr_abort(); the iterator is empty.
+
+\b Example:
+\code
+y_tokenizer ids = y_tokens_begin("IdList", ",");
+y_strview id;
+while( y_tokens_next(&ids, &id) )
+{
+    lr_log_message("id: %.*s", id.len, id.ptr);
+}
+y_tokens_end(&ids);
+\endcode
+\sa y_tokens_next(), y_tokens_end(), y_tokens_begin_view(), y_lines_begin()
+*/
+y_tokenizer y_tokens_begin(const char* param_name, const char* delimiter)
+{
+    return y_tokenizer_begin("y_tokens_begin", param_name, y_strview_from_string(delimiter), 0);
+}
+
+/*!
+\brief Start walking the tokens of a view, separated by a delimiter.
+
+As y_tokens_begin(), but for text that is already at hand - for example to split a line from y_lines_next() into fields.
+Nothing is copied: the view must remain valid while the iterator is in use. Calling y_tokens_end() is not required, but harmless.
+
+\param [in] text The text to walk.
+\param [in] delimiter The text between two tokens. Must not be empty.
+\returns The iterator.
+\sa y_tokens_begin(), y_tokens_next()
+*/
+y_tokenizer y_tokens_begin_view(y_strview text, const char* delimiter)
+{
+    y_tokenizer it;
+
+    memset(&it, 0, sizeof(it));
+    it.text = text;
+    it.delimiter = y_strview_from_string(delimiter);
+    it.done = (text.len == 0);
+    return it;
+}
+
+/*!
+\brief Get the next token from an iterator.
+\param [in,out] it The iterator, as returned by y_tokens_begin(), y_tokens_begin_view() or y_lines_begin().
+\param [out] token Receives the token, as a view on the text of the iterator. Valid until y_tokens_end() is called.
+\returns non-zero (true) if a token was found, zero (false) if there are no more tokens.
+\sa y_tokens_begin(), y_lines_next()
+*/
+int y_tokens_next(y_tokenizer* it, y_strview* token)
+{
+    y_strview rest;
+    int pos;
+
+    if( it->done )
+    {
+        return 0;
+    }
+
+    rest = y_strview_slice(it->text, it->pos, it->text.len);
+    pos = it->delimiter.len ? y_strview_find(rest, it->delimiter) : -1;
+    if( pos < 0 )
+    {
+        *token = rest;
+        it->pos = it->text.len;
+        it->done = 1;
+    }
+    else
+    {
+        *token = y_strview_slice(rest, 0, pos);
+        it->pos += pos + it->delimiter.len;
+        // Lines don't get an empty last line after a final newline.
+        it->done = it->lines && it->pos == it->text.len;
+    }
+
+    if( it->lines && token->len > 0 && token->ptr[token->len -1] == '\r' )
+    {
+        token->len--;
+    }
+    return 1;
+}
+
+/*!
+\brief Get the next line from a line iterator.
+\param [in,out] it The iterator, as returned by y_lines_begin().
+\param [out] line Receives the line, without the line end, as a view on the text of the iterator. Valid until y_lines_end() is called.
+\returns non-zero (true) if a line was found, zero (false) if there are no more lines.
+\sa y_lines_begin()
+*/
+int y_lines_next(y_tokenizer* it, y_strview* line)
+{
+    return y_tokens_next(it, line);
+}
+
+/*!
+\brief Release the resources held by an iterator.
+The views handed out by the iterator are no longer valid after this.
+\param [in,out] it The iterator.
+\sa y_tokens_begin(), y_lines_end()
+*/
+void y_tokens_end(y_tokenizer* it)
+{
+    if( it->buffer != NULL )
+    {
+        lr_eval_string_ext_free(&it->buffer);
+        it->buffer = NULL;
+    }
+    it->done = 1;
+}
+
+/*!
+\brief Release the resources held by a line iterator.
+\param [in,out] it The iterator.
+\sa y_lines_begin(), y_tokens_end()
+*/
+void y_lines_end(y_tokenizer* it)
+{
+    y_tokens_end(it);
+}
+
+/*!
+\brief A growable string buffer, for building large strings piece by piece.
+
+Appending to a y_strbuf takes time proportional to the size of what is appended, not the size of the whole string: the buffer
+grows geometrically, so building a string of N bytes costs O(N) in total. Compare that to lr_param_sprintf("param", "%s%s", ...),
+which reformats everything built so far on every call.
+
+The data is always '\0' terminated, but may contain null bytes of it's own when y_strbuf_append_bytes() was used.
+
+\b Example:
+\code
+y_strbuf body;
+int i;
+
+y_strbuf_init(&body, 0);
+y_strbuf_append(&body, "<order>");
+for( i=1; i <= y_array_count("PRODUCTS"); i++ )
+{
+    y_strbuf_appendf(&body, "<line nr=\"%d\">", i);
+    y_strbuf_append(&body, y_array_get("PRODUCTS", i));
+    y_strbuf_append(&body, "</line>");
+}
+y_strbuf_append(&body, "</order>");
+y_strbuf_save_to_param(&body, "OrderBody");
+y_strbuf_free(&body);
+\endcode
+\sa y_strbuf_init(), y_strview
+*/
+struct y_struct_strbuf
+{
+    //! The data. NULL until something is added.
+    char* data;
+    //! Length of the data, in bytes, excluding the terminating '\0'.
+    size_t len;
+    //! Allocated size of data.
+    size_t size;
+};
+//! \brief A growable string buffer. \sa y_struct_strbuf
+typedef struct y_struct_strbuf y_strbuf;
+
+/*!
+\brief Initialize a string buffer.
+\param [out] buf The buffer to initialize.
+\param [in] initial_size The number of bytes to allocate up front. Zero postpones allocation until something is added.
+\sa y_strbuf_free()
+*/
+void y_strbuf_init(y_strbuf* buf, size_t initial_size)
+{
+    buf->data = NULL;
+    buf->len = 0;
+    buf->size = 0;
+    if( initial_size > 0 )
+    {
+        buf->data = y_mem_alloc(initial_size);
+        buf->data[0] = '\0';
+        buf->size = initial_size;
+    }
+}
+
+/*!
+\brief Make sure a string buffer has room for a number of extra bytes, plus the terminating '\0'.
+\param [in] buf The buffer.
+\param [in] extra The number of bytes that will be added.
+*/
+void y_strbuf_reserve(y_strbuf* buf, size_t extra)
+{
+    size_t needed = buf->len + extra +1;
+    size_t size = buf->size ? buf->size : 64;
+
+    if( needed <= buf->size )
+        return;
+    while( size < needed )
+        size *= 2;
+
+    buf->data = (char*) realloc(buf->data, size);
+    if( buf->data == NULL )
+    {
+        lr_error_message("Out of memory: cannot allocate %d bytes for y_strbuf_reserve()", size);
+        lr_abort();
+        return;
+    }
+    if( buf->size == 0 )
+        buf->data[0] = '\0';
+    buf->size = size;
+}
+
+/*!
+\brief Append a block of memory to a string buffer. Binary safe.
+\param [in] buf The buffer.
+\param [in] data The data to append.
+\param [in] len The length of the data.
+*/
+void y_strbuf_append_bytes(y_strbuf* buf, const char* data, size_t len)
+{
+    y_strbuf_reserve(buf, len);
+    memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    buf->data[buf->len] = '\0';
+}
+
+/*!
+\brief Append a '\0' terminated string to a string buffer.
+\param [in] buf The buffer.
+\param [in] str The string to append.
+*/
+void y_strbuf_append(y_strbuf* buf, const char* str)
+{
+    y_strbuf_append_bytes(buf, str, strlen(str));
+}
+
+/*!
+\brief Append the content of a view to a string buffer. Binary safe.
+\param [in] buf The buffer.
+\param [in] view The data to append.
+*/
+void y_strbuf_append_view(y_strbuf* buf, y_strview view)
+{
+    y_strbuf_append_bytes(buf, view.ptr, view.len);
+}
+
+/*!
+\brief Append formatted text to a string buffer, printf() style.
+\param [in] buf The buffer.
+\param [in] format The format string, as for printf().
+\param [in] ... The values to format.
+*/
+void y_strbuf_appendf(y_strbuf* buf, const char* format, ...)
+{
+    va_list args;
+    int written;
+
+    y_strbuf_reserve(buf, 64);
+    for(;;)
+    {
+        size_t available = buf->size - buf->len;
+
+        va_start(args, format);
+        written = vsnprintf(buf->data + buf->len, available, format, args);
+        va_end(args);
+
+        if( written >= 0 && (size_t) written < available )
+        {
+            buf->len += written;
+            return;
+        }
+        // Too small. Grow to the reported size, or just double it if the C library didn't tell us.
+        y_strbuf_reserve(buf, written >= 0 ? (size_t) written : available * 2);
+    }
+}
+
+/*!
+\brief Append the content of a parameter to a string buffer. Binary safe.
+\param [in] buf The buffer.
+\param [in] param_name The name of the parameter. If it does not exist, this logs an error and calls lr_abort().
+*/
+void y_strbuf_append_param(y_strbuf* buf, const char* param_name)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview view = y_get_parameter_view(param_name);
+
+    if( view.ptr == NULL )
+    {
+        lr_error_message("y_strbuf_append_param(): Parameter %s does not exist!", param_name);
+        lr_abort();
+    }
+    else
+    {
+        y_strbuf_append_view(buf, view);
+    }
+    y_arena_release(mark);
+}
+
+/*!
+\brief Save the content of a string buffer into a parameter. Binary safe.
+
+The data is handed to lr_save_var() directly, without an intermediate copy. The buffer is left as it was.
+\param [in] buf The buffer.
+\param [in] param_name The name of the parameter to save it in.
+*/
+void y_strbuf_save_to_param(y_strbuf* buf, const char* param_name)
+{
+    lr_save_var(buf->len ? buf->data : "", buf->len, 0, param_name);
+}
+
+/*!
+\brief Empty a string buffer, but keep the memory for reuse.
+\param [in] buf The buffer.
+*/
+void y_strbuf_reset(y_strbuf* buf)
+{
+    buf->len = 0;
+    if( buf->data != NULL )
+        buf->data[0] = '\0';
+}
+
+/*!
+\brief Read a line of any length from a file into a string buffer, replacing its content.
+
+The line is read in pieces with fgets(), so there is no limit on its length. The newline at the end, if any, is kept.
+\param [in] buf The buffer.
+\param [in] file The file to read from, as returned by fopen().
+\returns non-zero (true) if a line was read, zero (false) at the end of the file.
+
+\b Example:
+\code
+y_strbuf line;
+long fp = fopen("input.txt", "r");
+y_strbuf_init(&line, 0);
+while( y_strbuf_read_line(&line, fp) )
+    lr_log_message("Line: %s", line.data);
+fclose(fp);
+y_strbuf_free(&line);
+\endcode
+*/
+int y_strbuf_read_line(y_strbuf* buf, long file)
+{
+    char chunk[1024];
+    size_t len;
+
+    y_strbuf_reset(buf);
+    while( fgets(chunk, sizeof chunk, file) != NULL )
+    {
+        len = strlen(chunk);
+        y_strbuf_append_bytes(buf, chunk, len);
+        if( len > 0 && chunk[len -1] == '\n' )
+            return 1;
+    }
+    return buf->len > 0;
+}
+
+/*!
+\brief Free the memory held by a string buffer. The buffer can be reused afterwards as if it was just initialized.
+\param [in] buf The buffer.
+*/
+void y_strbuf_free(y_strbuf* buf)
+{
+    free(buf->data);
+    y_strbuf_init(buf, 0);
+}
+
+/*!
+\brief Copy a parameter to a new name.
+This is a semi-efficiënt parameter copy using lr_eval_string_ext(), with appropriate freeing of memory.
+\param [in] source_param The parameter to copy.
+\param [in] dest_param The name of the parameter to copy the first parameter to.
+
+\b Example:
+\code
+lr_save_string("text", "param_a");
+y_copy_param("param_a", "param_b");   // Results in an exact copy of the content of param_a being stored in param_b.
+lr_log_message(lr_eval_string("param_b: {param_b}")); // Prints "param_b: text".
+\endcode
+\author Floris Kraak
+*/
+void y_copy_param(char* source_param, char* dest_param)
+{
+    char* buffer;
+    unsigned long size;
+    y_arena_mark mark = y_arena_get_mark();
+    char* source = y_arena_get_parameter_eval_string(source_param); // Puts the parameter name into parameter seperators { }.
+    lr_eval_string_ext(source, strlen(source), &buffer, &size, 0, 0, -1); // Evaluates the result and copy the data into buffer.
+    y_arena_release(mark);                     // Release the intermediate parameter name.
+    lr_save_var(buffer, size, 0, dest_param);  // Save the result.
+    lr_eval_string_ext_free(&buffer);          // Free the buffer.
+}
+
+//! \cond internal_functions
+/*
+Convert the ASCII letters in a block of memory to upper or lower case, in place.
+Works on 4 bytes at a time: for each byte in a word the high bit of a mask is set if the byte is a letter of the wrong case,
+and shifting that bit down to 0x20 gives exactly the bit that needs to be flipped. Bytes outside the ASCII range are left alone.
+*/
+void y_ascii_case_fold(char* data, size_t len, int to_upper)
+{
+    // Per byte: the high bit of (b + below) is set if b >= first, the high bit of (b + above) if b > last.
+    unsigned int below = to_upper ? 0x1F1F1F1F : 0x3F3F3F3F;    // 0x80 - 'a', 0x80 - 'A'
+    unsigned int above = to_upper ? 0x05050505 : 0x25252525;    // 0x7F - 'z', 0x7F - 'Z'
+    char* end = data + len;
+    char* p = data;
+    unsigned int word;
+    unsigned int ascii;
+    unsigned int mask;
+
+    for( ; end - p >= 4; p += 4 )
+    {
+        memcpy(&word, p, 4);
+        ascii = word & 0x7F7F7F7F;
+        mask = (ascii + below) & ~(ascii + above) & ~word & 0x80808080;
+        if( mask != 0 )
+        {
+            word ^= mask >> 2;
+            memcpy(p, &word, 4);
+        }
+    }
+    for( ; p < end; p++ )
+    {
+        if( to_upper ? (*p >= 'a' && *p <= 'z') : (*p >= 'A' && *p <= 'Z') )
+        {
+            *p ^= 0x20;
+        }
+    }
+}
+
+// Convert a parameter to upper or lower case. The content is converted in the buffer it was fetched into, and saved from there.
+void y_case_fold_parameter(const char* function_name, const char* param_name, int to_upper)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview content = y_get_parameter_view(param_name);
+
+    if( content.ptr == NULL )
+    {
+        lr_error_message("Nonexistant parameter %s passed to %s(): Aborting.", param_name, function_name);
+        lr_abort();
+        y_arena_release(mark);
+        return;
+    }
+    y_ascii_case_fold((char*) content.ptr, content.len, to_upper);
+    y_save_view(content, param_name);
+    y_arena_release(mark);
+}
+//! \endcond
+
+/*!
+\brief Convert the content of a parameter to UPPERCASE. 
+
+This will replace the content of the paramenter named in 'param_name' with the uppercased version.
+Only the ASCII letters a-z are converted; everything else, including accented characters, is left alone. Binary safe.
+The conversion is done 4 bytes at a time, without copying the parameter more than LoadRunner itself does.
+
+\param [in] param_name The parameter to convert to uppercase.
+
+\b Example:
+\code
+lr_save_string("aBcDeFgHiJ &*45#$@#)!({}", "Test");
+lr_message(lr_eval_string("Original: {Test}\n"));
+y_uppercase_parameter("Test");
+lr_message(lr_eval_string("Altered: {Test}\n")); // prints "Altered: ABCDEFGHIJ &*45#$@#)!({}".
+\endcode
+\sa y_lowercase_parameter()
+\author Floris Kraak
+*/
+void y_uppercase_parameter(const char* param_name)
+{
+    y_case_fold_parameter("y_uppercase_parameter", param_name, 1);
+}
+
+/*!
+\brief Convert the content of a parameter to lowercase. 
+
+This will replace the content of the paramenter named in 'param_name' with the lowercased version.
+Only the ASCII letters A-Z are converted; everything else, including accented characters, is left alone. Binary safe.
+
+\param [in] param_name The parameter to convert to lowercase.
+
+\b Example:
+\code
+lr_save_string("aBcDeFgHiJ &*45#$@#)!({}", "Test");
+y_lowercase_parameter("Test");
+lr_message(lr_eval_string("Altered: {Test}\n")); // prints "Altered: abcdefghij &*45#$@#)!({}".
+\endcode
+\sa y_uppercase_parameter()
+*/
+void y_lowercase_parameter(const char* param_name)
+{
+    y_case_fold_parameter("y_lowercase_parameter", param_name, 0);
+}
+
+/*!
+\brief Save a substring of a parameter into a new parameter.
+Search for a specific substring inside a parameter using left and right boundaries and save that into a new parameter.
+
+\param [in] original_parameter The parameter to search.
+\param [in] result_parameter The name of the parameter to store the result in.
+\param [in] left The left boundary - the text immediately preceding the substring in question.
+\param [in] right The right boundary.
+
+\b Example:
+\code
+char* str = "LorumIpsumLipsum";
+lr_save_string(str, "param");
+y_substr("param", "param", "Lorum", "Lipsum");
+lr_log_message(lr_eval_string("{param}")); // Prints "Ipsum".
+\endcode
+\author André Luyer, Marcel Jepma & Floris Kraak
+*/
+void y_substr(const char *original_parameter, const char *result_parameter, const char *left, const char *right)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview str = y_get_parameter_view(original_parameter);
+    if( str.ptr == NULL )
+    {
+        lr_error_message("y_substr(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+
+    y_save_view(y_substr_view(str, y_strview_from_string(left), y_strview_from_string(right)), result_parameter);
+    y_arena_release(mark);
+}
+
+/*!
+\brief Save a substring of a parameter into a new parameter, ignoring differences in case when searching for the boundaries.
+Case insensitive version of y_substr(). The boundaries are matched while scanning; the parameter itself is not converted or copied.
+
+\param [in] original_parameter The parameter to search.
+\param [in] result_parameter The name of the parameter to store the result in.
+\param [in] left The left boundary - the text immediately preceding the substring in question.
+\param [in] right The right boundary.
+
+\b Example:
+\code
+lr_save_string("<TITLE>Welcome</TITLE>", "param");
+y_substr_i("param", "title", "<title>", "</title>");
+lr_log_message(lr_eval_string("{title}")); // Prints "Welcome".
+\endcode
+\sa y_substr(), y_find_i()
+*/
+void y_substr_i(const char *original_parameter, const char *result_parameter, const char *left, const char *right)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview str = y_get_parameter_view(original_parameter);
+    int pos;
+
+    if( str.ptr == NULL )
+    {
+        lr_error_message("y_substr_i(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    if( left != NULL && (pos = y_strview_find_i(str, y_strview_from_string(left))) >= 0 )
+    {
+        str = y_strview_slice(str, pos + strlen(left), str.len);
+    }
+    if( right != NULL && (pos = y_strview_find_i(str, y_strview_from_string(right))) >= 0 )
+    {
+        str.len = pos;
+    }
+    y_save_view(str, result_parameter);
+    y_arena_release(mark);
+}
+
+/*!
+\brief Save the Nth piece of text between two boundaries in a parameter into a new parameter.
+
+Like web_reg_save_param() with "ORD=n", but after the fact, and with the option to count from the end.
+The parameter is scanned once, and only as far as needed: counting from the end the search starts at the end,
+so y_substr_nth(..., -1) only looks at the part of the parameter after the last left boundary.
+
+\param [in] original_parameter The parameter to search.
+\param [in] result_parameter The name of the parameter to store the result in. If there is no such match, it is not touched.
+\param [in] left The left boundary - the text immediately preceding the substring in question. Must not be empty.
+\param [in] right The right boundary. Must not be empty.
+\param [in] n Which match: 1 for the first, 2 for the second, and so on. -1 for the last, -2 for the one before that, and so on.
+\returns non-zero (true) if the match was found and saved, zero (false) otherwise.
+
+\b Example:
+\code
+lr_save_string("<tr>one</tr><tr>two</tr><tr>three</tr><tr>four</tr>", "Table");
+y_substr_nth("Table", "Row", "<tr>", "</tr>", 3);    // {Row} is "three"
+y_substr_nth("Table", "Row", "<tr>", "</tr>", -1);   // {Row} is "four"
+\endcode
+\sa y_substr_nth_view(), y_substr(), y_last_right()
+*/
+int y_substr_nth(const char *original_parameter, const char *result_parameter, const char *left, const char *right, int n)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview str = y_get_parameter_view(original_parameter);
+    y_strview result;
+    int found = 0;
+
+    if( str.ptr == NULL )
+    {
+        lr_error_message("y_substr_nth(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    else if( left == NULL || *left == '\0' || right == NULL || *right == '\0' || n == 0 )
+    {
+        lr_error_message("y_substr_nth(): Error: Empty boundary or n = 0 passed. Both boundaries must be given, and n must be non-zero.");
+        lr_abort();
+    }
+    else if( (found = y_substr_nth_view(str, y_strview_from_string(left), y_strview_from_string(right), n, &result)) != 0 )
+    {
+        y_save_view(result, result_parameter);
+    }
+    y_arena_release(mark);
+    return found;
+}
+
+
+/*!
+\brief Split a string into 2 parts using the search string. Save the left part into the result parameter.
+\param [in] original_parameter The parameter to search.
+\param [in] search The text after the text we're looking for.
+\param [in] result_parameter The name of the parameter to store the result in.
+
+\b Example:
+\code
+lr_save_string("AstrixObelixIdefix", "Test");
+lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}=AstrixObelixIdefix
+y_left( "Test", "Obelix", "Test2" );
+lr_message(lr_eval_string("New Param: {Test2}\n"));    // {Test2}=Astrix
+\endcode
+\author Floris Kraak
+*/
+void y_left( const char *original_parameter, const char *search, const char *result_parameter )
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview original = y_get_parameter_view(original_parameter);
+    if( original.ptr == NULL )
+    {
+        lr_error_message("y_left(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    else if( search == NULL || *search == '\0' )
+    {
+        lr_log_message("Warning: Empty search parameter passed to y_left()");
+    }
+    y_save_view(y_left_view(original, y_strview_from_string(search)), result_parameter);
+    y_arena_release(mark);
+}
+
+/*!
+\brief Save the text before the first occurrence of a search string into the result parameter, ignoring differences in case.
+Case insensitive version of y_left().
+\param [in] original_parameter The parameter to search.
+\param [in] search The text after the text we're looking for.
+\param [in] result_parameter The name of the parameter to store the result in.
+
+\b Example:
+\code
+lr_save_string("AstrixObelixIdefix", "Test");
+y_left_i( "Test", "OBELIX", "Test2" );
+lr_message(lr_eval_string("New Param: {Test2}\n"));    // {Test2}=Astrix
+\endcode
+\sa y_left(), y_find_i()
+*/
+void y_left_i( const char *original_parameter, const char *search, const char *result_parameter )
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview original = y_get_parameter_view(original_parameter);
+    int pos = -1;
+
+    if( original.ptr == NULL )
+    {
+        lr_error_message("y_left_i(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    else if( search == NULL || *search == '\0' )
+    {
+        lr_log_message("Warning: Empty search parameter passed to y_left_i()");
+    }
+    else
+    {
+        pos = y_strview_find_i(original, y_strview_from_string(search));
+    }
+    if( pos >= 0 )
+    {
+        original.len = pos;
+    }
+    y_save_view(original, result_parameter);
+    y_arena_release(mark);
+}
+
+
+
+/*!
+\brief Split a string into 2 parts using the search string. Save the right part into the result parameter.
+\param [in] original_parameter The parameter to search.
+\param [in] search The text preceding the text we're looking for.
+\param [in] result_parameter The name of the parameter to store the result in.
+
+\b Example:
+\code
+lr_save_string("AstrixObelixIdefix", "Test");
+lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}=AstrixObelixIdefix
+y_right( "Test", "Obelix", "Test4" );
+lr_message(lr_eval_string("New Param: {Test4}\n"));    //    {Test4}=Idefix
+\endcode
+\author Floris Kraak
+*/
+void y_right( const char *original_parameter, const char *search, const char *result_parameter)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview original = y_get_parameter_view(original_parameter);
+    if( original.ptr == NULL )
+    {
+        lr_error_message("y_right(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    else if( search == NULL || *search == '\0' )
+    {
+        lr_log_message("Warning: Empty search parameter passed to y_right()");
+    }
+    y_save_view(y_right_view(original, y_strview_from_string(search)), result_parameter);
+    y_arena_release(mark);
+}
+
+/*!
+\brief Save the text after the first occurrence of a search string into the result parameter, ignoring differences in case.
+Case insensitive version of y_right().
+\param [in] original_parameter The parameter to search.
+\param [in] search The text preceding the text we're looking for.
+\param [in] result_parameter The name of the parameter to store the result in.
+
+\b Example:
+\code
+lr_save_string("AstrixObelixIdefix", "Test");
+y_right_i( "Test", "obelix", "Test4" );
+lr_message(lr_eval_string("New Param: {Test4}\n"));    //    {Test4}=Idefix
+\endcode
+\sa y_right(), y_find_i()
+*/
+void y_right_i( const char *original_parameter, const char *search, const char *result_parameter)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview original = y_get_parameter_view(original_parameter);
+    int pos = -1;
+
+    if( original.ptr == NULL )
+    {
+        lr_error_message("y_right_i(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    else if( search == NULL || *search == '\0' )
+    {
+        lr_log_message("Warning: Empty search parameter passed to y_right_i()");
+    }
+    else
+    {
+        pos = y_strview_find_i(original, y_strview_from_string(search));
+    }
+    if( pos >= 0 )
+    {
+        original = y_strview_slice(original, pos + strlen(search), original.len);
+    }
+    y_save_view(original, result_parameter);
+    y_arena_release(mark);
+}
+
+
+
+/*!
+\brief Split a string into 2 parts using the search string. Save the rightmost part into the result parameter.
+This is almost the same as y_right(), but doesn't stop at the first match - instead, it uses the *last* match.
+It's pretty much the difference between 'greedy' and 'not greedy' in a regular expression..
+The parameter is searched from the end backwards, so the text before the last match is never looked at.
+
+\param [in] original_parameter The parameter to search.
+\param [in] search The text preceding the text we're looking for.
+\param [in] result_parameter The name of the parameter to store the result in.
+
+\b Example:
+\code
+lr_save_string("AstrixObelixIdefix", "Test");
+lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}=AstrixObelixIdefix
+y_last_right( "Test", "e", "Test4" );
+lr_message(lr_eval_string("New Param: {Test4}\n"));    //    {Test4}=fix (y_right() would give "lixIdefix")
+\endcode
+\sa y_right(), y_substr_nth(), y_rfind()
+\author Floris Kraak
+*/
+void y_last_right( const char *original_parameter, const char *search, const char *result_parameter)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview original = y_get_parameter_view(original_parameter);
+    if( original.ptr == NULL )
+    {
+        lr_error_message("y_last_right(): Error: Parameter %s does not exist!", original_parameter);
+        lr_abort();
+    }
+    else if( search == NULL || *search == '\0' )
+    {
+        lr_log_message("Warning: Empty search parameter passed to y_last_right()");
+    }
+    y_save_view(y_last_right_view(original, y_strview_from_string(search)), result_parameter);
+    y_arena_release(mark);
+}
+
+
+
+/*!
+\brief Split a string into 2 parts based on a search string
+
+\warning Unlike the others this one does not use parameter, but raw char pointers instead.
+This mostly to accomodate y_array_split().
+For the parameter version use y_split().
+
+\param [in] original The string to search.
+\param [in] separator The string to use as a seperation marker between the two parts.
+\param [in] left A preallocated char* buffer to hold the left hand side of the result.
+\param [in] right A preallocated char* buffer to hold the right hand side of the result.
+\author Floris Kraak
+*/
+void y_split_str( const char *original, const char *separator, char *left, char *right)
+{
+    y_strview left_view, right_view;
+
+    //lr_log_message("y_split_str: original=%s, search=%s", original, search);
+
+    if( !y_split_view(y_strview_from_string(original), y_strview_from_string(separator), &left_view, &right_view) )
+    {
+        // Copy the original to the left hand output buffer.
+        memcpy(left, original, left_view.len +1); // Let's not forget to copy the null byte, too.
+        return;
+    }
+
+    // Copy the left hand side and make the cut by putting a null character at the end.
+    memcpy(left, left_view.ptr, left_view.len);
+    left[left_view.len] = '\0';
+
+    // Copy the right hand side starting from the position just after the found string.
+    memcpy(right, right_view.ptr, right_view.len +1); // Let's not forget to copy the null byte, too.
+}
+
+
+
+/*!
+\brief Split a parameter in two based on a seperating string.
+If the seperator is not found in the original parameter the original parameter will be stored in it's entirety in the left hand parameter.
+
+\param [in] originalParameter The parameter to search. If it does not exist this logs an error and calls lr_abort().
+\param [in] separator The string to use as a seperation marker between the two parts.
+\param [in] leftParameter The parameter that will hold the left hand side of the split result.
+\param [in] rightParameter The parameter that will hold the right hand side of the split result.
+
+\b Example:
+\code
+lr_save_string("WackoYackoDotWarner", "Test");
+lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}    = WackoYackoDotWarner
+y_split("Test", "Yacko", "Left", "Right");           // Use "Yacko" as the separator
+lr_message(lr_eval_string("Original: {Test}\n"));    // {Test}    = WackoYackoDotWarner
+lr_message(lr_eval_string("Left    : {Left}\n"));    // {Left}    = Wacko
+lr_message(lr_eval_string("Right   : {Right}\n"));   // {Right}   = DotWarner
+\endcode
+\author Floris Kraak
+*/
+void y_split( const char *originalParameter, const char *separator, const char *leftParameter, const char *rightParameter)
+{
+    y_strview left, right;
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview item = y_get_parameter_view(originalParameter);
+
+    if( item.ptr == NULL )
+    {
+        lr_error_message("y_split(): Error: Parameter %s does not exist!", originalParameter);
+        y_arena_release(mark);
+        lr_abort();
+        return;
+    }
+
+    // If the separator isn't found the full original string gets stored in the left hand parameter
+    // and the right hand parameter will be empty.
+    y_split_view(item, y_strview_from_string(separator), &left, &right);
+
+    // Store the results in parameters.
+    y_save_view(left, leftParameter);
+    y_save_view(right, rightParameter);
+    y_arena_release(mark);
+}
+
+
+
+/*!
+\brief Remove leading and trailing whitespace from a parameter.
+
+This does not support unicode, so it may not catch everything.
+Supported whitespace is: 
+  " "(=space)
+  "\r"(=carrige return)
+  "\n"(=line feed)
+  "\t"(=tab)
+The result is stored in the original parameter.
+
+\param [in] parameter The parameter to chop. If it does not exist this logs an error and calls lr_abort().
+
+\b Example:
+\code
+lr_save_string("  WackoYackoDot ", "Test");
+lr_message(lr_eval_string("Original: >{Test}<\n"));    // {Test}= "  WackoYackoDot "
+y_chop("Test");
+lr_message(lr_eval_string("Original: >{Test}<\n"));    // {Test}= "WackoYackoDot"
+\endcode
+\author: Floris Kraak
+*/
+void y_chop( const char* parameter )
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview value = y_get_parameter_view(parameter);
+
+    if( value.ptr == NULL )
+    {
+        lr_error_message("y_chop(): Error: Parameter %s does not exist!", parameter);
+        y_arena_release(mark);
+        lr_abort();
+        return;
+    }
+
+    //lr_output_message( "y_chop(%s)", parameter);    
+    y_save_view(y_strview_trim(value), parameter);
+    y_arena_release(mark);
+}
+
+
+
+/*!
+\brief Search and replace inside a parameter, up to a maximum number of replacements.
 This replaces the content of the originally passed-in parameter with the new content when done.
 
-\note This one has a built-in search/y_replace limit. After 1000 replacements it will stop.
-If 1000 replacements in a single parameter does not suffice consider using other methods.
+The parameter is scanned twice: once to count the matches, and once to build the result.
+The result buffer is allocated exactly once and every byte is copied exactly once, so this remains linear regardless of the number of matches.
+Matches do not overlap. Binary safe.
+
+\param [in] parameter The parameter to search.
+\param [in] search What to search for.
+\param [in] replace What to replace it with.
+\param [in] max_replacements The maximum number of replacements to make. A negative number means there is no limit.
+\returns The number of replacements made.
+
+\b Example:
+\code
+lr_save_string("a-b-c-d", "par1");
+y_replace_n("par1", "-", "+", 2);        // {par1} now has the value a+b+c-d
+\endcode
+\sa y_replace()
+*/
+int y_replace_n( const char *parameter, const char *search, const char *replace, int max_replacements )
+{
+    y_strview string, needle, rest;
+    size_t rlen, size;
+    int count = 0;
+    int pos;
+    char *buffer, *out;
+    y_arena_mark mark;
+
+    if( search == NULL || *search == '\0' || replace == NULL || max_replacements == 0 )
+        return 0;
+    if( strcmp(search, replace) == 0 )
+        return 0;   // search == replace: nothing changes
+
+    mark = y_arena_get_mark();
+    string = y_get_parameter_view(parameter);
+    needle = y_strview_from_string(search);
+    rlen = strlen(replace);
+
+    // First pass: count the matches.
+    rest = string;
+    while( (max_replacements < 0 || count < max_replacements) && (pos = y_strview_find(rest, needle)) >= 0 )
+    {
+        count++;
+        rest = y_strview_slice(rest, pos + needle.len, rest.len);
+    }
+    if( count == 0 )
+    {
+        y_arena_release(mark);
+        return 0;
+    }
+
+    //lr_log_message("y_replace_n(%s, %s, %s) - %d matches", parameter, search, replace, count);
+
+    // Second pass: build the result, one allocation and one copy.
+    size = string.len - (count * needle.len) + (count * rlen);
+    buffer = y_arena_alloc(size +1);
+    out = buffer;
+    rest = string;
+    for( pos = 0; pos < count; pos++ )
+    {
+        int match = y_strview_find(rest, needle);
+        memcpy(out, rest.ptr, match);
+        out += match;
+        memcpy(out, replace, rlen);
+        out += rlen;
+        rest = y_strview_slice(rest, match + needle.len, rest.len);
+    }
+    memcpy(out, rest.ptr, rest.len);
+    buffer[size] = '\0';
+
+    lr_save_var(buffer, size, 0, parameter);
+    y_arena_release(mark);
+    return count;
+}
+
+/*!
+\brief Search and replace inside a parameter.
+This replaces the content of the originally passed-in parameter with the new content when done.
+There is no limit to the number of replacements. Use y_replace_n() to limit it.
 
 \param [in] parameter The parameter to search.
 \param [in] search What to search for.
@@ -510,75 +1758,11 @@ If 1000 replacements in a single parameter does not suffice consider using other
 lr_save_string("test123", "par1");
 y_replace("par1", "1", "ing1");        // {par1} now has the value testing123
 \endcode
+\sa y_replace_n()
 */
 void y_replace( const char *parameter, const char *search, const char *replace )
 {
-   int slen, rlen, plen;      // lengte van search, replace, en basis string
-   int i = 0;                 // aantal replacements
-   int limit = 1000;          // replacement limiet als replace > search
-
-   char *c;                   // punt waar change moet beginnen
-   char *cend;                // einde van de change = c+slen
-   char *last;                // de \0 slotbyte van input string
-   char *buffer;              // buffer voor bewerkingen
-   char *string;              // originele string waar we in zoeken
-
-   if ((search == NULL)     || (strlen(search) <1)) 
-       return;
-   if (!search || !replace)      return;   // ongeldige search of_replace
-   if (!strcmp(search, replace)) return;   // search == replace: geen wijziging
-
-   slen = strlen (search);          // de lengte van search
-   rlen = strlen (replace);         // de lengte van replace
-
-   string = y_get_parameter(parameter); // <-- memory allocated by loadrunner, too small if replace > search
-   plen = strlen(string);
-
-   //lr_log_message("y_replace(%s, %s, %s) - slen %d, rlen %d, plen %d", parameter, search, replace, slen, rlen, plen);
-    
-   if ( rlen > slen)
-   {
-      // Reserve memory for -limit- replacements.
-      size_t size = plen + ((rlen-slen) * limit);
-      buffer = y_mem_alloc( size );
-      snprintf( buffer, size, "%s", string );
-   }
-   else
-   {
-      // No need to reserve memory
-      buffer = string;
-   }
-
-   last = buffer + strlen(buffer) +1;      // het einde van de string, de null byte
-   c = buffer;                             // initialiseer c - buffer moet intact blijven
-
-   while (c = (char*) strstr(c, search))   // doorzoek de search string vanaf waar je gebleven bent
-   {
-      //lr_output_message("c:%s", c);
- 
-      i++;
-      if (slen != rlen)                    // zijn search en replace van verschillende lengte?
-      {
-         if( i >= limit )
-         {
-            lr_log_message("Unable to handle more than %d search-and-replaces, apologies for the inconvenience.", limit);
-            break;
-         }
-         cend = c+slen;                        // cend is de plaats van waaraf de string moet opschuiven
-         //lr_output_message("memmove(dest=%d, src=%d, size=%d)", (long)(c+rlen), (long)(cend), (long)(last-cend) );
-         memmove (c+rlen , cend, last-cend);   // verplaats de rest van de string - als de geheugenberekening niet klopt gaat dit stuk!
-         //lr_output_message("memmove completed, result = %s", c);
-         last = last - slen + rlen;            // en bereken het nieuwe eindpunt
-      }
-      memmove(c, replace, rlen);  // execute the replacement
-      c += rlen;                  // start the next search at the point where the replacement ended
-   }
-   lr_save_string(buffer, parameter);
-
-   if( rlen > slen )
-   {
-      free(buffer);
-   }
+    y_replace_n(parameter, search, replace, -1);
 }
 
 
@@ -587,6 +1771,7 @@ void y_replace( const char *parameter, const char *search, const char *replace )
 
 This is a lighter weight alternative to the y_replace() function in cases where just want to remove text, rather than replace it with something else.
 Stores the result in the original parameter.
+The text is compacted in a single pass, copying every byte that stays at most once. Binary safe.
 
 \param [in] paramName The parameter to search.
 \param [in] removeMe The text to remove.
@@ -596,12 +1781,15 @@ Stores the result in the original parameter.
 lr_save_string("test123", "par1");
 y_remove_string_from_parameter("par1", "1");   // {par1} now has the value test23
 \endcode
+\sa y_remove_strings_from_parameter()
 */
 void y_remove_string_from_parameter(const char* paramName, const char* removeMe)
 {
-   char *parameter;
-   char *removePtr;
-   int remlen;
+   y_strview source, rest, needle;
+   char *buffer;
+   size_t len = 0;
+   int pos;
+   y_arena_mark mark;
  
    //lr_log_message("y_remove_string_from_parameter( remove:%s, parameter:%s )", removeMe, paramName);
 
@@ -609,22 +1797,652 @@ void y_remove_string_from_parameter(const char* paramName, const char* removeMe)
       return;
 
    // fetch the contents of the parameter to change
-   parameter = y_get_parameter(paramName);
-   // removePtr is used to track our progress through this string
-   removePtr = parameter;
-   remlen = strlen(removeMe);
+   mark = y_arena_get_mark();
+   source = y_get_parameter_view(paramName);
+   needle = y_strview_from_string(removeMe);
+
+   if( (pos = y_strview_find(source, needle)) < 0 )
+   {
+      y_arena_release(mark);
+      return; // nothing to remove
+   }
 
-   // while we find occurrances of the string we're looking for
-   while ( removePtr = (char *)strstr( removePtr, removeMe ) )
+   // copy everything between the occurrences of the string we're looking for into the result
+   buffer = y_arena_alloc(source.len +1);
+   rest = source;
+   do
    {
-      // copy the characters between the end of the data we wish to remove and end-of-string 
-      // to the place where we found our offending content.
-      char* origin = removePtr + remlen;
-      strncpy(removePtr, origin, (strlen(origin)+1));
+      memcpy(buffer + len, rest.ptr, pos);
+      len += pos;
+      rest = y_strview_slice(rest, pos + needle.len, rest.len);
    }
+   while( (pos = y_strview_find(rest, needle)) >= 0 );
+   memcpy(buffer + len, rest.ptr, rest.len);
+   len += rest.len;
 
    // store it in the original parameter
-   lr_save_string( parameter, paramName );
+   lr_save_var(buffer, len, 0, paramName);
+   y_arena_release(mark);
+}
+
+
+/*!
+\brief Remove all occurrences of several texts from a parameter, in one pass.
+
+Like y_remove_string_from_parameter(), but for a whole list of texts at once. This is useful for normalising a response,
+for example by stripping a set of markup tags and whitespace sequences, without rescanning the response once for every text.
+Stores the result in the original parameter.
+
+At every position in the parameter the longest matching text in the list is removed. Empty and NULL entries in the list are ignored.
+Binary safe.
+
+\param [in] paramName The parameter to search.
+\param [in] removeList An array of texts to remove.
+\param [in] removeCount The number of entries in removeList.
+
+\b Example:
+\code
+char* tags[] = { "<b>", "</b>", "<i>", "</i>", "\r", "\n" };
+lr_save_string("<b>bold</b> and <i>italic</i>\r\n", "par1");
+y_remove_strings_from_parameter("par1", tags, 6);   // {par1} now has the value "bold and italic"
+\endcode
+\sa y_remove_string_from_parameter()
+*/
+void y_remove_strings_from_parameter(const char* paramName, char** removeList, int removeCount)
+{
+    unsigned char first[256];   // Which bytes start one of the texts in the list?
+    size_t *lengths;
+    y_strview source;
+    const char *read, *end;
+    char *buffer, *write;
+    int i;
+    y_arena_mark mark;
+
+    if( removeList == NULL || removeCount < 1 )
+        return;
+
+    mark = y_arena_get_mark();
+    lengths = (size_t*) y_arena_alloc(removeCount * sizeof(size_t));
+    memset(first, 0, sizeof(first));
+    for( i = 0; i < removeCount; i++ )
+    {
+        lengths[i] = removeList[i] ? strlen(removeList[i]) : 0;
+        if( lengths[i] > 0 )
+        {
+            first[(unsigned char)removeList[i][0]] = 1;
+        }
+    }
+
+    source = y_get_parameter_view(paramName);
+    buffer = y_arena_alloc(source.len +1);
+    write = buffer;
+    read = source.ptr;
+    end = source.ptr + source.len;
+
+    while( read < end )
+    {
+        size_t match = 0;
+
+        if( first[(unsigned char)*read] )
+        {
+            for( i = 0; i < removeCount; i++ )
+            {
+                if( lengths[i] > match && lengths[i] <= (size_t)(end - read) && memcmp(read, removeList[i], lengths[i]) == 0 )
+                {
+                    match = lengths[i];
+                }
+            }
+        }
+
+        if( match > 0 )
+        {
+            read += match;
+        }
+        else
+        {
+            *write++ = *read++;
+        }
+    }
+
+    if( (size_t)(write - buffer) != source.len )
+    {
+        lr_save_var(buffer, write - buffer, 0, paramName);
+    }
+    y_arena_release(mark);
+}
+
+
+/*! \brief A compiled set of search/replace pairs, for y_replace_many().
+
+This is an Aho-Corasick automaton over all search strings, stored as a complete transition table over byte classes.
+Only bytes that occur in one of the search strings get their own class, which keeps the table small.
+Compiled automatons are cached for the rest of the test. They are never freed.
+
+\sa y_replace_many(), y_replace_automaton_compile()
+*/
+struct y_struct_replace_automaton
+{
+    //! The next automaton in the cache.
+    struct y_struct_replace_automaton* next;
+    //! Hash over the search/replace pairs, used as the cache key.
+    unsigned int key;
+    //! The file the pairs were read from, or NULL. \sa y_replace_many_from_file()
+    char* filename;
+    //! The number of search/replace pairs.
+    int pair_count;
+    //! The search strings.
+    char** search;
+    //! The replacement strings.
+    char** replace;
+    //! Length of each replacement string.
+    size_t* replace_len;
+    //! Length of each search string.
+    size_t* search_len;
+    //! Maps every byte value to it's byte class. Class 0 is for bytes that occur in none of the search strings.
+    unsigned char byte_class[256];
+    //! The number of byte classes.
+    int class_count;
+    //! The number of states.
+    int state_count;
+    //! Transition table, state_count * class_count entries.
+    int* delta;
+    //! The length of the longest prefix of a search string that leads to each state.
+    int* depth;
+    //! For each state, the longest search string that ends in it, or -1.
+    int* output;
+    //! For each state, the nearest state on it's failure chain that spells out a complete search string, or 0 (the root) if there is none.
+    //! Following these links from a state finds every search string ending there, not just the longest. \sa y_extract_many()
+    int* dictionary_link;
+};
+//! \brief A compiled set of search/replace pairs. \sa y_struct_replace_automaton
+typedef struct y_struct_replace_automaton y_replace_automaton;
+
+/*! \brief The maximum number of compiled automatons kept in the cache.
+
+Adding one more to a full cache frees the oldest one, so scripts that build endless unique sets of pairs use a bounded amount of memory.
+\sa y_replace_many(), y_replace_many_cache_clear()
+*/
+#define Y_REPLACE_AUTOMATON_CACHE_LIMIT 64
+
+//! \cond internal_global
+//! INTERNAL: Cache of compiled replace automatons, newest first. \sa y_replace_many()
+y_replace_automaton* _y_replace_automatons = NULL;
+//! \endcond
+
+/*!
+\brief Calculate the cache key for a set of search/replace pairs.
+\param [in] search The search strings.
+\param [in] replace The replacement strings.
+\param [in] pair_count The number of pairs.
+\returns The key.
+*/
+unsigned int y_replace_pairs_key(char** search, char** replace, int pair_count)
+{
+    unsigned int key = pair_count;
+    int i;
+
+    for( i = 0; i < pair_count; i++ )
+    {
+        key = key * 31 + y_hash_string(search[i], strlen(search[i]));
+        key = key * 31 + y_hash_string(replace[i], strlen(replace[i]));
+    }
+    return key;
+}
+
+/*!
+\brief Compile a set of search/replace pairs into an automaton for y_replace_automaton_apply().
+
+Most scripts will want to use y_replace_many() instead, which calls this and caches the result.
+
+\param [in] search The search strings. Empty strings are ignored.
+\param [in] replace The replacement strings.
+\param [in] pair_count The number of pairs.
+\returns The compiled automaton, allocated with y_mem_alloc(). The strings are copied, so the arguments do not need to stay around.
+\sa y_replace_many(), y_replace_automaton_apply()
+*/
+y_replace_automaton* y_replace_automaton_compile(char** search, char** replace, int pair_count)
+{
+    y_replace_automaton* ac = (y_replace_automaton*) y_array_alloc(sizeof(y_replace_automaton), 1);
+    int max_states = 1;
+    int *fail, *queue;
+    int head = 0, tail = 0;
+    int i, c;
+
+    ac->key = y_replace_pairs_key(search, replace, pair_count);
+    ac->pair_count = pair_count;
+    ac->search = (char**) y_mem_alloc(pair_count * sizeof(char*) +1);
+    ac->replace = (char**) y_mem_alloc(pair_count * sizeof(char*) +1);
+    ac->search_len = (size_t*) y_mem_alloc(pair_count * sizeof(size_t) +1);
+    ac->replace_len = (size_t*) y_mem_alloc(pair_count * sizeof(size_t) +1);
+
+    // Copy the pairs and assign byte classes.
+    ac->class_count = 1;
+    for( i = 0; i < pair_count; i++ )
+    {
+        size_t j;
+        ac->search[i] = y_strdup(search[i]);
+        ac->replace[i] = y_strdup(replace[i]);
+        ac->search_len[i] = strlen(search[i]);
+        ac->replace_len[i] = strlen(replace[i]);
+        max_states += ac->search_len[i];
+        for( j = 0; j < ac->search_len[i]; j++ )
+        {
+            unsigned char b = (unsigned char) search[i][j];
+            if( ac->byte_class[b] == 0 )
+            {
+                ac->byte_class[b] = ac->class_count++;
+            }
+        }
+    }
+
+    // Build the trie. State 0 is the root. -1 means 'no transition yet'.
+    ac->delta = (int*) y_mem_alloc(max_states * ac->class_count * sizeof(int));
+    ac->depth = (int*) y_array_alloc(max_states, sizeof(int));
+    ac->output = (int*) y_mem_alloc(max_states * sizeof(int));
+    ac->dictionary_link = (int*) y_array_alloc(max_states, sizeof(int));
+    memset(ac->delta, 0xff, max_states * ac->class_count * sizeof(int));
+    ac->output[0] = -1;
+    ac->state_count = 1;
+
+    for( i = 0; i < pair_count; i++ )
+    {
+        int state = 0;
+        size_t j;
+
+        for( j = 0; j < ac->search_len[i]; j++ )
+        {
+            int* next = &ac->delta[state * ac->class_count + ac->byte_class[(unsigned char) ac->search[i][j]]];
+            if( *next < 0 )
+            {
+                *next = ac->state_count;
+                ac->depth[ac->state_count] = ac->depth[state] +1;
+                ac->output[ac->state_count] = -1;
+                ac->state_count++;
+            }
+            state = *next;
+        }
+        if( state != 0 && ac->output[state] < 0 )
+        {
+            ac->output[state] = i; // On duplicate search strings the first one wins.
+        }
+    }
+
+    // Breadth first: fill in the failure links and complete the transition table.
+    fail = (int*) y_mem_alloc(ac->state_count * sizeof(int));
+    queue = (int*) y_mem_alloc(ac->state_count * sizeof(int));
+    fail[0] = 0;
+    for( c = 0; c < ac->class_count; c++ )
+    {
+        int next = ac->delta[c];
+        if( next < 0 )
+        {
+            ac->delta[c] = 0;
+        }
+        else
+        {
+            fail[next] = 0;
+            queue[tail++] = next;
+        }
+    }
+    while( head < tail )
+    {
+        int state = queue[head++];
+        int f = fail[state];
+
+        // The failure state is shallower, so it's links are already known.
+        ac->dictionary_link[state] = (f != 0 && ac->output[f] >= 0 && ac->search_len[ac->output[f]] == (size_t) ac->depth[f]) ? f : ac->dictionary_link[f];
+
+        // The longest search string ending here is either the one this state spells, or the one its failure state has.
+        if( ac->output[state] < 0 )
+        {
+            ac->output[state] = ac->output[fail[state]];
+        }
+        for( c = 0; c < ac->class_count; c++ )
+        {
+            int* next = &ac->delta[state * ac->class_count + c];
+            if( *next < 0 )
+            {
+                *next = ac->delta[fail[state] * ac->class_count + c];
+            }
+            else
+            {
+                fail[*next] = ac->delta[fail[state] * ac->class_count + c];
+                queue[tail++] = *next;
+            }
+        }
+    }
+    free(queue);
+    free(fail);
+
+    return ac;
+}
+
+/*!
+\brief Free an automaton made by y_replace_automaton_compile().
+
+Only use this on automatons that were compiled by hand. The ones made by y_replace_many() and friends belong to the cache. Use y_replace_many_cache_clear() for those.
+\param [in] ac The automaton.
+\sa y_replace_automaton_compile()
+*/
+void y_replace_automaton_free(y_replace_automaton* ac)
+{
+    int i;
+
+    for( i = 0; i < ac->pair_count; i++ )
+    {
+        free(ac->search[i]);
+        free(ac->replace[i]);
+    }
+    free(ac->search);
+    free(ac->replace);
+    free(ac->search_len);
+    free(ac->replace_len);
+    free(ac->delta);
+    free(ac->depth);
+    free(ac->output);
+    free(ac->dictionary_link);
+    free(ac->filename);
+    free(ac);
+}
+
+/*!
+\brief Rewrite a parameter in one pass with a compiled set of search/replace pairs.
+
+Matches are replaced leftmost first. If several search strings match at the same position the longest one wins.
+Replaced text is not searched again, so the result does not depend on the order of the pairs - unlike calling y_replace() once for every pair.
+Binary safe.
+
+\param [in] ac The automaton, as returned by y_replace_automaton_compile().
+\param [in] parameter The parameter to rewrite. The result is stored in the same parameter.
+\returns The number of replacements made.
+\sa y_replace_many(), y_replace_automaton_compile()
+*/
+int y_replace_automaton_apply(y_replace_automaton* ac, const char* parameter)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview source = y_get_parameter_view(parameter);
+    const unsigned char* text = (const unsigned char*) source.ptr;
+    int* matches = NULL;   // pairs of (start, pair index)
+    int match_count = 0, match_capacity = 0;
+    size_t size = source.len;
+    size_t pos = 0;
+    int i;
+
+    // Scan for the matches. The leftmost candidate is committed once no longer match can start at or before it.
+    while( pos < source.len )
+    {
+        int state = 0;
+        size_t p = pos;
+        int best = -1;
+        size_t best_start = 0;
+
+        while( p < source.len )
+        {
+            int out;
+            state = ac->delta[state * ac->class_count + ac->byte_class[text[p++]]];
+            out = ac->output[state];
+            if( out >= 0 )
+            {
+                size_t start = p - ac->search_len[out];
+                if( best < 0 || start < best_start || (start == best_start && ac->search_len[out] > ac->search_len[best]) )
+                {
+                    best = out;
+                    best_start = start;
+                }
+            }
+            if( best >= 0 && p - ac->depth[state] > best_start )
+            {
+                break;
+            }
+        }
+        if( best < 0 )
+        {
+            break;
+        }
+
+        if( match_count == match_capacity )
+        {
+            match_capacity = match_capacity ? match_capacity * 2 : 64;
+            matches = (int*) realloc(matches, match_capacity * 2 * sizeof(int));
+            if( matches == NULL )
+            {
+                lr_error_message("Out of memory in y_replace_automaton_apply()");
+                lr_abort();
+                y_arena_release(mark);
+                return 0;
+            }
+        }
+        matches[match_count * 2] = best_start;
+        matches[match_count * 2 +1] = best;
+        match_count++;
+        size = size - ac->search_len[best] + ac->replace_len[best];
+        pos = best_start + ac->search_len[best];
+    }
+
+    // Build the result: one allocation, every byte copied once.
+    if( match_count > 0 )
+    {
+        char* buffer = y_arena_alloc(size +1);
+        char* out = buffer;
+        pos = 0;
+        for( i = 0; i < match_count; i++ )
+        {
+            size_t start = matches[i * 2];
+            int pair = matches[i * 2 +1];
+            memcpy(out, source.ptr + pos, start - pos);
+            out += start - pos;
+            memcpy(out, ac->replace[pair], ac->replace_len[pair]);
+            out += ac->replace_len[pair];
+            pos = start + ac->search_len[pair];
+        }
+        memcpy(out, source.ptr + pos, source.len - pos);
+        buffer[size] = '\0';
+        lr_save_var(buffer, size, 0, parameter);
+    }
+
+    free(matches);
+    y_arena_release(mark);
+    return match_count;
+}
+
+//! \cond internal_functions
+// Add an automaton to the cache. If that makes the cache too big the oldest entry is freed.
+void y_replace_automaton_cache_add(y_replace_automaton* ac)
+{
+    y_replace_automaton* last;
+    int count = 1;
+
+    ac->next = _y_replace_automatons;
+    _y_replace_automatons = ac;
+
+    for( last = ac; last->next != NULL; last = last->next )
+    {
+        if( ++count > Y_REPLACE_AUTOMATON_CACHE_LIMIT )
+        {
+            y_replace_automaton_free(last->next);
+            last->next = NULL;
+            break;
+        }
+    }
+}
+
+// Find the cached automaton for a set of search/replace pairs, or compile and cache a new one.
+// The result stays valid until the next automaton is added to the cache.
+y_replace_automaton* y_replace_automaton_get(char** search, char** replace, int pair_count)
+{
+    unsigned int key = y_replace_pairs_key(search, replace, pair_count);
+    y_replace_automaton* ac;
+
+    for( ac = _y_replace_automatons; ac != NULL; ac = ac->next )
+    {
+        if( ac->key == key && ac->filename == NULL && ac->pair_count == pair_count )
+        {
+            int i;
+            for( i = 0; i < pair_count; i++ )
+            {
+                if( strcmp(ac->search[i], search[i]) != 0 || strcmp(ac->replace[i], replace[i]) != 0 )
+                    break;
+            }
+            if( i == pair_count )
+                break;
+        }
+    }
+
+    if( ac == NULL )
+    {
+        ac = y_replace_automaton_compile(search, replace, pair_count);
+        y_replace_automaton_cache_add(ac);
+    }
+    return ac;
+}
+//! \endcond
+
+/*!
+\brief Search and replace a whole set of strings in a parameter, in one pass.
+
+This builds an Aho-Corasick automaton from the search/replace pairs and rewrites the parameter with it in a single pass.
+The automaton is cached, keyed by the set of pairs, so only the first call with a given set pays for building it.
+The cache holds up to Y_REPLACE_AUTOMATON_CACHE_LIMIT automatons. When it is full the oldest one is dropped. y_replace_many_cache_clear() empties it.
+
+Calling y_replace() once for every pair scans and rewrites the whole parameter once per pair. With this it's done once, total.
+
+Matches are replaced leftmost first. If several search strings match at the same position the longest one wins.
+Replaced text is not searched again.
+
+\param [in] parameter The parameter to rewrite. The result is stored in the same parameter.
+\param [in] search An array of search strings.
+\param [in] replace An array of replacement strings, one for every search string.
+\param [in] pair_count The number of search/replace pairs.
+\returns The number of replacements made.
+
+\b Example:
+\code
+char* search[] = { "{{name}}", "{{city}}", "Amsterdam" };
+char* replace[] = { "John", "Amsterdam", "Rotterdam" };
+lr_save_string("{{name}} lives in {{city}}, not in Amsterdam.", "Template");
+y_replace_many("Template", search, replace, 3);   // {Template} is now "John lives in Amsterdam, not in Rotterdam."
+\endcode
+\sa y_replace_many_from_file(), y_array_replace_many(), y_replace()
+*/
+int y_replace_many(const char* parameter, char** search, char** replace, int pair_count)
+{
+    return y_replace_automaton_apply(y_replace_automaton_get(search, replace, pair_count), parameter);
+}
+
+/*!
+\brief Search and replace a whole set of strings in a parameter in one pass, with the search/replace pairs read from a file.
+
+As y_replace_many(), but the pairs come from a text file. Each line holds a search string and a replacement, separated by a tab.
+Lines starting with '#' and lines without a tab are ignored. Lines can be of any length.
+The file is normally read only once per virtual user: the compiled automaton is cached by file name, in the same cache as y_replace_many() uses.
+
+\param [in] parameter The parameter to rewrite. The result is stored in the same parameter.
+\param [in] filename The file to read the search/replace pairs from.
+\returns The number of replacements made.
+
+\b Example:
+\code
+// anonymise.txt:
+// John	Person1
+// Amsterdam	City1
+y_replace_many_from_file("Response", "anonymise.txt");
+\endcode
+\sa y_replace_many()
+*/
+int y_replace_many_from_file(const char* parameter, const char* filename)
+{
+    y_replace_automaton* ac;
+
+    for( ac = _y_replace_automatons; ac != NULL; ac = ac->next )
+    {
+        if( ac->filename != NULL && strcmp(ac->filename, filename) == 0 )
+            break;
+    }
+
+    if( ac == NULL )
+    {
+        long fp = fopen(filename, "r");
+        y_strbuf buf;
+        char** search = NULL;
+        char** replace = NULL;
+        int count = 0, capacity = 0;
+        int i;
+
+        if( fp == NULL )
+        {
+            lr_error_message("Unable to open file %s", filename);
+            lr_abort();
+            return 0;
+        }
+
+        y_strbuf_init(&buf, 0);
+        while( y_strbuf_read_line(&buf, fp) )
+        {
+            char* line = buf.data;
+            char* remove;
+            char* tab;
+
+            // Remove trailing newlines.
+            while( ((remove = strchr(line, '\r')) != NULL) || ((remove = strchr(line, '\n')) != NULL) )
+            {
+                remove[0] = '\0';
+            }
+            if( line[0] == '#' || (tab = strchr(line, '\t')) == NULL )
+            {
+                continue;
+            }
+            *tab = '\0';
+
+            if( count == capacity )
+            {
+                capacity = capacity ? capacity * 2 : 64;
+                search = (char**) realloc(search, capacity * sizeof(char*));
+                replace = (char**) realloc(replace, capacity * sizeof(char*));
+                if( search == NULL || replace == NULL )
+                {
+                    lr_error_message("Out of memory while reading %s", filename);
+                    lr_abort();
+                    return 0;
+                }
+            }
+            search[count] = y_strdup(line);
+            replace[count] = y_strdup(tab +1);
+            count++;
+        }
+        fclose(fp);
+        y_strbuf_free(&buf);
+        lr_log_message("Read %d search/replace pairs from %s", count, filename);
+
+        ac = y_replace_automaton_compile(search, replace, count);
+        ac->filename = y_strdup((char*)filename);
+        y_replace_automaton_cache_add(ac);
+
+        for( i = 0; i < count; i++ )
+        {
+            free(search[i]);
+            free(replace[i]);
+        }
+        free(search);
+        free(replace);
+    }
+    return y_replace_automaton_apply(ac, parameter);
+}
+
+/*!
+\brief Free all automatons cached by y_replace_many(), y_replace_many_from_file() and y_extract_many().
+
+The next call with a set of pairs builds the automaton again. A file is read again.
+Use this to release the memory once a script is done with a large set of pairs.
+\sa y_replace_many(), Y_REPLACE_AUTOMATON_CACHE_LIMIT
+*/
+void y_replace_many_cache_clear()
+{
+    while( _y_replace_automatons != NULL )
+    {
+        y_replace_automaton* next = _y_replace_automatons->next;
+        y_replace_automaton_free(_y_replace_automatons);
+        _y_replace_automatons = next;
+    }
 }
 
 
@@ -691,6 +2509,7 @@ void y_random_string_buffer_core(const char *parameter, int minimumLength, int m
 
    char randomNumber;
    int lettersInWord;
+   y_arena_mark mark;
 
    charSetSize=strlen(characterSet);
 
@@ -731,8 +2550,9 @@ void y_random_string_buffer_core(const char *parameter, int minimumLength, int m
    }
 
    // get memory for the buffer
-   buffer = (char *)y_mem_alloc( max +1 );
-   // note: if this fails y_mem_alloc() aborts the script, so no error handling needed.
+   mark = y_arena_get_mark();
+   buffer = y_arena_alloc( max +1 );
+   // note: if this fails y_arena_alloc() aborts the script, so no error handling needed.
 
    while( length < max )
    {
@@ -770,7 +2590,7 @@ void y_random_string_buffer_core(const char *parameter, int minimumLength, int m
    buffer[max] = '\0';
 
    lr_save_string(buffer, parameter);
-   free(buffer);
+   y_arena_release(mark);
 }
 
 //! Returns a random string with (pseudo) words created from a given string of characters
@@ -875,20 +2695,19 @@ char* y_get_cleansed_parameter(const char* param_name, char replacement)
 {
    char* result;
    unsigned long result_size;
-   size_t param_eval_size = strlen(param_name) +3; // parameter name + "{}" + '\0' (end of string)
-   char* param_eval_string = y_mem_alloc(param_eval_size);
+   y_arena_mark mark = y_arena_get_mark();
+   char* param_eval_string = y_arena_get_parameter_eval_string(param_name);
    //lr_log_message("y_cleanse_parameter(%s)", param_name );
 
    // Get the contents of the parameter using lr_eval_string_ext() - we can't use the
    // regular version if we expect to find NULL in there.
-   snprintf( param_eval_string, param_eval_size, "{%s}", param_name );
-   lr_eval_string_ext(param_eval_string, param_eval_size-1, &result, &result_size, 0, 0, -1);
+   lr_eval_string_ext(param_eval_string, strlen(param_eval_string), &result, &result_size, 0, 0, -1);
    if( strcmp(param_eval_string, result) == 0 )
    {
        lr_error_message("y_get_cleansed_parameter: Parameter %s does not exist.", param_name);
        lr_abort();
    }
-   free(param_eval_string);
+   y_arena_release(mark);
 
    //lr_log_message("Cleansing param %s, result starts with '%-*.*s' and contains %d bytes.", param_name, result_size, result_size, result, result_size);
    if (result_size) {
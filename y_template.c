@@ -0,0 +1,288 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_template.c
+\brief Precompiled payload templates with {param} slots.
+
+The classic way to send a templated request body is to read the template into a parameter once, and push it through lr_eval_string()
+for every request. That scans the entire template for braces every time, and breaks on templates containing null bytes.
+
+y_template_compile() reads a template file once and splits it into literal text and parameter references ("slots").
+y_template_render() then only has to evaluate the slots, add up the lengths and copy everything into place in one go.
+
+Slots use the same syntax as lr_eval_string(): {name}, where name consists of letters, digits and underscores.
+Braces around anything else, such as the braces of a JSON document, are left alone. So are slots naming parameters that do not exist,
+just as lr_eval_string() would.
+
+\b Example:
+\code
+Action()
+{
+    // File contains: <xml><customer_element>{customer_id}</customer_element></xml>
+    y_template* order = y_template_compile("order_template.xml");
+
+    y_template_render(order, "request_body");
+    web_custom_request("some_request",
+        "URL=http://{Host}/some/request/v1/",
+        "Method=POST", "Resource=0",
+        "Body={request_body}",
+        "EncType=text/xml; charset=utf-8",
+        LAST);
+}
+\endcode
+*/
+#ifndef _Y_TEMPLATE_C_
+//! \cond include_protection
+#define _Y_TEMPLATE_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_core.c"
+#include "y_string.c"
+
+//! \brief A piece of a compiled template: either literal text, or a parameter reference. \sa y_struct_template
+struct y_struct_template_segment
+{
+    //! The literal text, or for slots the text of the reference itself ("{name}"), used when the parameter does not exist.
+    y_strview text;
+    //! For slots, the index of the parameter in the parameter list of the template. -1 for literal text.
+    int param;
+};
+//! \brief A piece of a compiled template.
+typedef struct y_struct_template_segment y_template_segment;
+
+/*! \brief A compiled template. \sa y_template_compile() */
+struct y_struct_template
+{
+    //! The next template in the cache.
+    struct y_struct_template* next;
+    //! The file the template was read from.
+    char* filename;
+    //! The content of the file.
+    char* data;
+    //! The length of the content.
+    size_t len;
+    //! The segments.
+    y_template_segment* segments;
+    //! The number of segments.
+    int segment_count;
+    //! The distinct parameters referred to by the template. Each is evaluated once per render.
+    y_param** params;
+    //! The number of distinct parameters.
+    int param_count;
+    //! Scratch space: the values of the parameters during a render.
+    y_strview* values;
+    //! The buffer the result is built in. Kept around, so rendering does not allocate once it has grown large enough.
+    y_strbuf result;
+};
+//! \brief A compiled template. \sa y_template_compile()
+typedef struct y_struct_template y_template;
+
+//! \cond internal_global
+//! INTERNAL: Cache of compiled templates. \sa y_template_compile()
+y_template* _y_templates = NULL;
+//! \endcond
+
+
+//! \cond internal_functions
+int y_template_is_name_char(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
+
+// Split the template data into segments.
+void y_template_parse(y_template* tpl)
+{
+    const char* p = tpl->data;
+    const char* end = tpl->data + tpl->len;
+    const char* literal = p;
+    int segment_capacity = 16;
+    int param_capacity = 8;
+
+    tpl->segments = (y_template_segment*) y_mem_alloc(segment_capacity * sizeof(y_template_segment));
+    tpl->params = (y_param**) y_mem_alloc(param_capacity * sizeof(y_param*));
+
+    while( (p = (const char*) memchr(p, '{', end - p)) != NULL )
+    {
+        const char* name = p + 1;
+        const char* close = name;
+        y_param* param;
+        int i;
+
+        while( close < end && y_template_is_name_char(*close) )
+            close++;
+        if( close == name || close >= end || *close != '}' )
+        {
+            p++;
+            continue;
+        }
+
+        // Make room for a literal segment and a slot.
+        if( tpl->segment_count + 2 > segment_capacity )
+        {
+            segment_capacity *= 2;
+            tpl->segments = (y_template_segment*) realloc(tpl->segments, segment_capacity * sizeof(y_template_segment));
+        }
+        if( p > literal )
+        {
+            tpl->segments[tpl->segment_count].text = y_strview_make(literal, p - literal);
+            tpl->segments[tpl->segment_count++].param = -1;
+        }
+
+        // Look the parameter up. A parameter used more than once in the template is still only evaluated once.
+        {
+            y_arena_mark mark = y_arena_get_mark();
+            char* param_name = y_arena_alloc(close - name + 1);
+            memcpy(param_name, name, close - name);
+            param_name[close - name] = '\0';
+            param = y_param_resolve(param_name);
+            y_arena_release(mark);
+        }
+        for( i = 0; i < tpl->param_count && tpl->params[i] != param; i++ )
+            ;
+        if( i == tpl->param_count )
+        {
+            if( tpl->param_count == param_capacity )
+            {
+                param_capacity *= 2;
+                tpl->params = (y_param**) realloc(tpl->params, param_capacity * sizeof(y_param*));
+            }
+            tpl->params[tpl->param_count++] = param;
+        }
+        tpl->segments[tpl->segment_count].text = y_strview_make(p, close + 1 - p);
+        tpl->segments[tpl->segment_count++].param = i;
+
+        p = literal = close + 1;
+    }
+
+    if( end > literal )
+    {
+        if( tpl->segment_count + 1 > segment_capacity )
+            tpl->segments = (y_template_segment*) realloc(tpl->segments, (segment_capacity + 1) * sizeof(y_template_segment));
+        tpl->segments[tpl->segment_count].text = y_strview_make(literal, end - literal);
+        tpl->segments[tpl->segment_count++].param = -1;
+    }
+    tpl->values = (y_strview*) y_array_alloc(tpl->param_count + 1, sizeof(y_strview));
+}
+//! \endcond
+
+
+/*!
+\brief Read a template file and compile it.
+
+Compiled templates are cached by file name for the rest of the test, so this can be called from Action() without rereading the file each iteration.
+Changes to the file during the test are not picked up.
+
+\param [in] filename The name of the template file (relative to script root, or full path). Binary safe: the file may contain null bytes.
+\returns The compiled template. If the file cannot be read this logs an error and calls lr_abort().
+\sa y_template_render(), y_read_file_into_parameter()
+*/
+y_template* y_template_compile(const char* filename)
+{
+    y_template* tpl;
+    long f;
+    long size;
+
+    for( tpl = _y_templates; tpl != NULL; tpl = tpl->next )
+    {
+        if( strcmp(tpl->filename, filename) == 0 )
+            return tpl;
+    }
+
+    if( (f = fopen(filename, "rb")) == NULL )
+    {
+        lr_error_message("y_template_compile(): Unable to open file %s", filename);
+        lr_abort();
+        return NULL;
+    }
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+
+    tpl = (y_template*) y_array_alloc(1, sizeof(y_template));
+    tpl->data = y_mem_alloc(size + 1);
+    tpl->len = fread(tpl->data, 1, size, f);
+    tpl->data[tpl->len] = '\0';
+    fclose(f);
+
+    tpl->filename = y_strdup((char*)filename);
+    y_strbuf_init(&tpl->result, 0);
+    y_template_parse(tpl);
+
+    tpl->next = _y_templates;
+    _y_templates = tpl;
+    lr_log_message("y_template_compile(): %s: %d bytes, %d segments, %d distinct parameters", filename, tpl->len, tpl->segment_count, tpl->param_count);
+    return tpl;
+}
+
+/*!
+\brief Render a compiled template into a parameter.
+
+Each parameter the template refers to is evaluated once. The result is then assembled in a single buffer, sized up front, and saved.
+Binary safe: both the template and the parameter values may contain null bytes.
+
+\param [in] tpl The template, as returned by y_template_compile().
+\param [in] result_param The name of the parameter to save the result in.
+\returns The length of the result.
+\sa y_template_compile()
+*/
+int y_template_render(y_template* tpl, const char* result_param)
+{
+    size_t total = 0;
+    int i;
+
+    for( i = 0; i < tpl->param_count; i++ )
+    {
+        size_t len;
+        char* value = y_param_get(tpl->params[i], &len);
+        tpl->values[i] = y_strview_make(value, len);
+    }
+
+    for( i = 0; i < tpl->segment_count; i++ )
+    {
+        y_template_segment* segment = &tpl->segments[i];
+        if( segment->param >= 0 && tpl->values[segment->param].ptr != NULL )
+            total += tpl->values[segment->param].len;
+        else
+            total += segment->text.len;
+    }
+
+    y_strbuf_reset(&tpl->result);
+    y_strbuf_reserve(&tpl->result, total);
+    for( i = 0; i < tpl->segment_count; i++ )
+    {
+        y_template_segment* segment = &tpl->segments[i];
+        if( segment->param >= 0 && tpl->values[segment->param].ptr != NULL )
+            y_strbuf_append_view(&tpl->result, tpl->values[segment->param]);
+        else
+            y_strbuf_append_view(&tpl->result, segment->text);
+    }
+
+    y_strbuf_save_to_param(&tpl->result, result_param);
+    return tpl->result.len;
+}
+
+#endif // _Y_TEMPLATE_C_
@@ -113,6 +113,8 @@ Testcase
 // Use the get() and set() functions instead, if available. (otherwise, add them?)
 //! INTERNAL: Whether to add the name of the vuser group to the transaction names. 1 = on, 0 = off.
 int _y_add_group_to_trans = 0;      // 
+//! INTERNAL: Reused buffer for building transaction names. \see y_build_transaction_name()
+y_strbuf _y_transaction_name_buffer = {NULL, 0, 0};
 //! INTERNAL: Whether to create a graph detailing wasted time. Debugging option.
 int _y_wasted_time_graph = 0;       
 
@@ -499,7 +501,17 @@ void y_save_transaction_end_status(char* transaction_name, const char* saveparam
         // Fix me: Lookup the corresponding LR constant.
         lr_log_message("Warning: Possible attempt to close a transaction that has not been opened!");
     }
-    lr_save_int(status, saveparam);
+
+    // Parameter handles are never freed, so only resolve the one that is read back by y_get_last_transaction_status().
+    // Any other name is saved directly, so arbitrary names can't make the handle table grow.
+    if( strcmp(saveparam, "y_last_transaction_status") == 0 )
+    {
+        y_param_set_int(y_param_resolve(saveparam), status);
+    }
+    else
+    {
+        lr_save_int(status, saveparam);
+    }
 }
 
 
@@ -662,6 +674,52 @@ char *y_calculate_actual_transaction_prefix(const char *transaction_prefix)
 }
 
 
+/*! \brief Transaction name factory.
+
+Builds the complete transaction name out of the vuser group name (if applicable), the transaction prefix, the transaction number, the sub transaction number (if any) and the step name.
+Shared by y_create_new_transaction_name() and y_create_new_sub_transaction_name().
+
+\param [out] result The buffer to append the transaction name to.
+\param [in] transaction_name The name of the step.
+\param [in] transaction_prefix The current transaction prefix as given to y_start_transaction_block()
+\param [in] transaction_nr The transaction number.
+\param [in] sub_transaction_nr The sub transaction number, or a negative number for top level transactions.
+
+\see y_create_new_transaction_name(), y_create_new_sub_transaction_name(), y_strbuf
+*/
+void y_build_transaction_name(y_strbuf* result, const char *transaction_name, const char *transaction_prefix, int transaction_nr, int sub_transaction_nr)
+{
+    // y_virtual_user_group is set only if y_setup() is called.
+    // See y_loadrunner_utils.c
+    y_setup();
+
+    if( transaction_nr >= 100 )
+    {
+        lr_error_message("Transaction count too high (100+). Are you using y_start_action_block()?");
+        lr_exit(LR_EXIT_VUSER, LR_FAIL);
+    }
+
+    if( _y_add_group_to_trans && y_virtual_user_group[0] != '\0' )
+    {
+        y_strbuf_append(result, y_virtual_user_group);
+        y_strbuf_append(result, "_");
+    }
+    if( transaction_prefix[0] != '\0' )
+    {
+        y_strbuf_append(result, transaction_prefix);
+        y_strbuf_append(result, "_");
+    }
+    if( sub_transaction_nr < 0 )
+    {
+        y_strbuf_appendf(result, "%02d_", transaction_nr);
+    }
+    else
+    {
+        y_strbuf_appendf(result, "%02d_%02d_", transaction_nr, sub_transaction_nr);
+    }
+    y_strbuf_append(result, transaction_name);
+}
+
 //
 // Generates the transaction name prefixed with a user defined action prefix and a transaction number.
 // The result is saved in the "y_current_transaction" loadrunner parameter for use by some macro's.
@@ -676,22 +734,9 @@ char *y_calculate_actual_transaction_prefix(const char *transaction_prefix)
 //
 void y_create_new_transaction_name(const char *transaction_name, const char *transaction_prefix, int transaction_nr)
 {
-    const int trans_nr_len = 2;    // eg. '01'
-    char *actual_prefix = y_calculate_actual_transaction_prefix(transaction_prefix);
-    int prefix_len = strlen(actual_prefix);
-    int trans_name_size = prefix_len + trans_nr_len +1 + strlen(transaction_name) +1;
-    char *actual_trans_name = y_mem_alloc( trans_name_size );
-
-    if( transaction_nr >= 100 )
-    {
-        lr_error_message("Transaction count too high (100+). Are you using y_start_action_block()?");
-        lr_exit(LR_EXIT_VUSER, LR_FAIL);
-    }
-
-    snprintf(actual_trans_name, trans_name_size, "%s%02d_%s", actual_prefix, transaction_nr, transaction_name);
-    free(actual_prefix);
-    y_set_current_transaction_name(actual_trans_name);
-    free(actual_trans_name);
+    y_strbuf_reset(&_y_transaction_name_buffer);
+    y_build_transaction_name(&_y_transaction_name_buffer, transaction_name, transaction_prefix, transaction_nr, -1);
+    y_set_current_transaction_name(_y_transaction_name_buffer.data);
 }
 
 void y_create_next_transaction_name( const char* transaction_name)
@@ -700,29 +745,12 @@ void y_create_next_transaction_name( const char* transaction_name)
 }
 
 
-
-// 
-// Todo: Find a way to make this share more code with y_create_new_transaction_name()
-//
 void y_create_new_sub_transaction_name(const char *transaction_name, const char *transaction_prefix, 
                                        const int transaction_nr, const int sub_transaction_nr)
 {
-    const int trans_nr_len = 2;    // eg. '01'
-    char *actual_prefix = y_calculate_actual_transaction_prefix(transaction_prefix);
-    int prefix_len = strlen(actual_prefix);
-    int trans_name_size = prefix_len + (2 * (trans_nr_len +1)) + strlen(transaction_name) +1;
-    char *actual_trans_name = y_mem_alloc( trans_name_size );
-
-    if( transaction_nr >= 100 )
-    {
-        lr_error_message("Transaction count too high (100+). Are you using y_start_action_block()?");
-        lr_exit(LR_EXIT_VUSER, LR_FAIL);
-    }
-
-    snprintf(actual_trans_name, trans_name_size, "%s%02d_%02d_%s", actual_prefix, transaction_nr, sub_transaction_nr, transaction_name);
-    free(actual_prefix);
-    y_set_current_sub_transaction_name(actual_trans_name);
-    free(actual_trans_name);
+    y_strbuf_reset(&_y_transaction_name_buffer);
+    y_build_transaction_name(&_y_transaction_name_buffer, transaction_name, transaction_prefix, transaction_nr, sub_transaction_nr);
+    y_set_current_sub_transaction_name(_y_transaction_name_buffer.data);
 }
 
 
@@ -888,15 +916,18 @@ int y_end_sub_transaction(char *transaction_name, int status)
 
 int y_get_last_transaction_status()
 {
-    char* last_trans_status_string = y_get_parameter_or_null("y_last_transaction_status");
-    if( last_trans_status_string == NULL )
+    static y_param* last_trans_status = NULL;
+
+    if( last_trans_status == NULL )
     {
-        return LR_AUTO; // No earlier transaction, the parameter doesn't even exist.
+        last_trans_status = y_param_resolve("y_last_transaction_status");
     }
-    else
+    if( !y_param_exists(last_trans_status) )
     {
-        return atoi(last_trans_status_string);
+        return LR_AUTO; // No earlier transaction, the parameter doesn't even exist.
     }
+    // Saved by y_save_transaction_end_status() through the same handle, so this normally doesn't need to evaluate anything.
+    return y_param_get_int(last_trans_status);
 }
 
 
@@ -970,6 +1001,7 @@ void y_trans_web_link(char *transaction, char *linkname)
     char *link = lr_eval_string(linkname);
     char *tmp, *trans;
     size_t size;
+    y_arena_mark mark;
 
     if( !(strlen(link) > 0) )
     {
@@ -978,8 +1010,9 @@ void y_trans_web_link(char *transaction, char *linkname)
         return;
     }
     
+    mark = y_arena_get_mark();
     size = strlen(link) + strlen("Text=") +1;
-    tmp = y_mem_alloc(size);
+    tmp = y_arena_alloc(size);
     snprintf(tmp, size, "Text=%s", link);
 
     trans = lr_eval_string(transaction);
@@ -987,7 +1020,7 @@ void y_trans_web_link(char *transaction, char *linkname)
     web_link(link, tmp, LAST);
     y_end_transaction(trans, LR_AUTO);
     
-    free(tmp);
+    y_arena_release(mark);
 }
 
 
@@ -1096,12 +1129,11 @@ void y_add_dynatrace_header(char* transaction_name, char* additional_headers)
 		web_save_timestamp_param("y_dynatrace_timestamp", LAST);
 		
 		{
-			char* timestamp = lr_eval_string("{y_dynatrace_timestamp}");
-			int header_length = strlen(transaction_name)+4 + strlen(vuserstring)+4 + strlen(timestamp)+4 + strlen(additional_headers)+1;
-			char* header = (char*) y_mem_alloc(sizeof(char) * header_length);
-			snprintf(header, header_length, "NA=%s;VU=%s;%ID=%s;%s", transaction_name, vuserstring, timestamp, additional_headers);		
-			web_add_auto_header("X-dynaTrace", header);
-			free(header);
+			y_strbuf header;
+			y_strbuf_init(&header, 0);
+			y_strbuf_appendf(&header, "NA=%s;VU=%s;ID=%s;%s", transaction_name, vuserstring, lr_eval_string("{y_dynatrace_timestamp}"), additional_headers);
+			web_add_auto_header("X-dynaTrace", header.data);
+			y_strbuf_free(&header);
 		}
 	}
 }
@@ -0,0 +1,571 @@
+/*
+ * Ylib Loadrunner function library.
+ * Copyright (C) 2005-2014 Floris Kraak <randakar@gmail.com> | <fkraak@ymor.nl>
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ */
+
+/*
+ * Documentation generated from this source code can be found here: http://randakar.github.io/y-lib/
+ * Main git repitory can be found at https://github.com/randakar/y-lib
+ */
+
+
+/*!
+\file y_xml.c
+\brief XML support: extracting values by path, SOAP style.
+
+y_xml_get() and friends tokenize an XML document once, from start to end, without building a tree out of it.
+Values found at the requested paths are saved into parameters or parameter arrays on the way.
+
+Paths look like "/Envelope/Body/GetOrderResponse/Order/Id":
+- Each step is the name of a child element. Namespace prefixes are ignored on both sides, so the path above matches
+  \<soap:Envelope\>\<soap:Body\>\<m:GetOrderResponse\> as well as \<env:Envelope\>\<env:Body\>\<GetOrderResponse\> - whatever prefixes
+  the server happens to pick.
+- A step of * matches any element.
+- A last step of \@name selects an attribute of the element, for example "/Envelope/Body/Order/@id".
+
+The text of matched elements is saved with entities (&amp;amp; &amp;#233; etc.) decoded and CDATA sections unwrapped.
+If a matched element contains child elements, it's content is saved as XML text instead.
+
+\b Example:
+\code
+// {Response} contains <s:Envelope xmlns:s="..."><s:Body><m:Orders><m:Order id="7"><m:Total>10.00</m:Total></m:Order>
+//                     <m:Order id="8"><m:Total>5&amp;6</m:Total></m:Order></m:Orders></s:Body></s:Envelope>
+y_xml_get("Response", "/Envelope/Body/Orders/Order/@id", "OrderId");    // {OrderId_1} is "7", {OrderId_2} is "8"
+y_xml_get("Response", "/Envelope/Body/Orders/Order/Total", "Total");    // {Total_1} is "10.00", {Total_2} is "5&6"
+\endcode
+*/
+#ifndef _Y_XML_C_
+//! \cond include_protection
+#define _Y_XML_C_
+//! \endcond
+
+#include "vugen.h"
+#include "y_string.c"
+#include "y_param_array.c"
+
+//! \brief The maximum number of steps in an XML path.
+#define Y_XML_MAX_PATH_DEPTH 32
+//! \brief The maximum number of paths y_xml_get_multi() can match in one pass.
+#define Y_XML_MAX_PATHS 32
+
+//! \brief A parsed XML path, and where to save the values that match it. \sa y_xml_get_multi()
+struct y_struct_xml_path
+{
+    //! The element names for each step. "*" matches any element.
+    y_strview steps[Y_XML_MAX_PATH_DEPTH];
+    //! The number of element steps.
+    int depth;
+    //! The attribute to save, if the path ends in \@name. Otherwise the ptr member is NULL.
+    y_strview attribute;
+    //! The parameter or parameter array to save matches in.
+    const char* result;
+    //! Non-zero to save only the first match, as a single parameter.
+    int single;
+    //! The number of matches so far.
+    int count;
+    //! Where the content of the element being captured starts, or NULL if there is none.
+    const char* content_start;
+};
+//! \brief A parsed XML path.
+typedef struct y_struct_xml_path y_xml_path;
+
+
+//! \cond internal_functions
+// Parse a path. Returns 0 and logs an error if the path is invalid.
+int y_xml_parse_path(const char* path, y_xml_path* result)
+{
+    const char* p = path;
+
+    memset(result, 0, sizeof(y_xml_path));
+    if( *p != '/' )
+    {
+        lr_error_message("y_xml: Path %s does not start with a '/'", path);
+        return 0;
+    }
+
+    while( *p == '/' )
+    {
+        const char* name = ++p;
+        while( *p != '\0' && *p != '/' )
+            p++;
+        if( p == name )
+        {
+            lr_error_message("y_xml: Empty step in path %s", path);
+            return 0;
+        }
+        if( *name == '@' )
+        {
+            if( *p != '\0' || p - name == 1 )
+            {
+                lr_error_message("y_xml: An attribute can only be the last step of path %s", path);
+                return 0;
+            }
+            result->attribute = y_strview_make(name + 1, p - name - 1);
+            break;
+        }
+        if( result->depth >= Y_XML_MAX_PATH_DEPTH )
+        {
+            lr_error_message("y_xml: Path too deep: %s", path);
+            return 0;
+        }
+        result->steps[result->depth++] = y_strview_make(name, p - name);
+    }
+    if( result->depth == 0 )
+    {
+        lr_error_message("y_xml: Path %s has no elements", path);
+        return 0;
+    }
+    return 1;
+}
+
+// Strip the namespace prefix from a name.
+y_strview y_xml_local_name(const char* name, size_t len)
+{
+    const char* colon = (const char*) memchr(name, ':', len);
+    if( colon != NULL )
+        return y_strview_make(colon + 1, len - (colon + 1 - name));
+    return y_strview_make(name, len);
+}
+
+int y_xml_is_name_char(char c)
+{
+    return c != '\0' && strchr(" \t\r\n/>=", c) == NULL;
+}
+
+/*
+Decode text content: entities are replaced and CDATA sections unwrapped. dest must have room for len bytes.
+Returns the length of the result, or -1 if the text contains elements (or anything else that isn't text).
+*/
+int y_xml_decode_text(const char* src, size_t len, char* dest)
+{
+    const char* end = src + len;
+    char* out = dest;
+
+    while( src < end )
+    {
+        if( *src == '<' )
+        {
+            const char* cdata_end;
+            if( end - src < 12 || strncmp(src, "<![CDATA[", 9) != 0 )
+                return -1;
+            cdata_end = y_find(src + 9, end - src - 9, "]]>", 3);
+            if( cdata_end == NULL )
+                return -1;
+            memcpy(out, src + 9, cdata_end - src - 9);
+            out += cdata_end - src - 9;
+            src = cdata_end + 3;
+        }
+        else if( *src == '&' )
+        {
+            const char* semicolon = (const char*) memchr(src, ';', end - src < 12 ? end - src : 12);
+            unsigned int c = 0;
+            size_t name_len;
+
+            if( semicolon == NULL )
+            {
+                *out++ = *src++;
+                continue;
+            }
+            name_len = semicolon - src - 1;
+            if( name_len == 2 && strncmp(src + 1, "lt", 2) == 0 ) c = '<';
+            else if( name_len == 2 && strncmp(src + 1, "gt", 2) == 0 ) c = '>';
+            else if( name_len == 3 && strncmp(src + 1, "amp", 3) == 0 ) c = '&';
+            else if( name_len == 4 && strncmp(src + 1, "quot", 4) == 0 ) c = '"';
+            else if( name_len == 4 && strncmp(src + 1, "apos", 4) == 0 ) c = '\'';
+            else if( name_len > 1 && src[1] == '#' )
+            {
+                char number[12];
+                memcpy(number, src + 2, name_len - 1);
+                number[name_len - 1] = '\0';
+                c = (number[0] == 'x' || number[0] == 'X') ? strtoul(number + 1, NULL, 16) : strtoul(number, NULL, 10);
+            }
+            if( c == 0 || c > 0x10FFFF )
+            {
+                // Unknown entity. Leave it as it is.
+                *out++ = *src++;
+                continue;
+            }
+            src = semicolon + 1;
+            if( c < 0x80 )
+                *out++ = c;
+            else if( c < 0x800 )
+            {
+                *out++ = 0xC0 | (c >> 6);
+                *out++ = 0x80 | (c & 0x3F);
+            }
+            else if( c < 0x10000 )
+            {
+                *out++ = 0xE0 | (c >> 12);
+                *out++ = 0x80 | ((c >> 6) & 0x3F);
+                *out++ = 0x80 | (c & 0x3F);
+            }
+            else
+            {
+                *out++ = 0xF0 | (c >> 18);
+                *out++ = 0x80 | ((c >> 12) & 0x3F);
+                *out++ = 0x80 | ((c >> 6) & 0x3F);
+                *out++ = 0x80 | (c & 0x3F);
+            }
+        }
+        else
+        {
+            *out++ = *src++;
+        }
+    }
+    return out - dest;
+}
+
+// Save a match for a path. The value is decoded if it's plain text, and saved as is otherwise.
+void y_xml_save_match(y_xml_path* path, const char* value, size_t len)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    const char* name = path->single ? path->result : y_arena_array_element_name(path->result, path->count + 1);
+
+    if( memchr(value, '<', len) != NULL || memchr(value, '&', len) != NULL )
+    {
+        char* decoded = y_arena_alloc(len + 1);
+        int decoded_len = y_xml_decode_text(value, len, decoded);
+        if( decoded_len >= 0 )
+        {
+            value = decoded;
+            len = decoded_len;
+        }
+    }
+    lr_save_var(len ? value : "", len, 0, name);
+    y_arena_release(mark);
+    path->count++;
+}
+
+// Find an attribute in the attribute text of a start tag (everything between the element name and the closing '>'), and save it.
+void y_xml_save_attribute(y_xml_path* path, const char* attributes, const char* end)
+{
+    const char* p = attributes;
+
+    while( p < end )
+    {
+        const char* name;
+        y_strview local;
+        char quote;
+        const char* value;
+        const char* value_end;
+
+        while( p < end && !y_xml_is_name_char(*p) )
+            p++;
+        name = p;
+        while( p < end && y_xml_is_name_char(*p) )
+            p++;
+        local = y_xml_local_name(name, p - name);
+        while( p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') )
+            p++;
+        if( p >= end || *p != '=' )
+            continue;
+        p++;
+        while( p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n') )
+            p++;
+        if( p >= end || (*p != '"' && *p != '\'') )
+            return;
+        quote = *p++;
+        value = p;
+        if( (value_end = (const char*) memchr(value, quote, end - value)) == NULL )
+            return;
+        p = value_end + 1;
+
+        // Namespace declarations are not attributes.
+        if( p - name > 5 && strncmp(name, "xmlns", 5) == 0 && (name[5] == '=' || name[5] == ':') )
+            continue;
+        if( y_strview_equals(local, path->attribute) )
+        {
+            y_xml_save_match(path, value, value_end - value);
+            return;
+        }
+    }
+}
+
+// Match a number of parsed paths against a parameter in a single pass. Returns 0 if the document is invalid.
+int y_xml_scan(const char* function_name, const char* source_param, y_xml_path* paths, int path_count)
+{
+    y_arena_mark mark = y_arena_get_mark();
+    y_strview document = y_get_parameter_view(source_param);
+    unsigned int active[Y_XML_MAX_PATH_DEPTH + 1];
+    unsigned int wanted = path_count >= 32 ? 0xFFFFFFFFu : (1u << path_count) - 1;
+    const char* p;
+    const char* end;
+    const char* error = NULL;
+    int depth = 0;
+    int i;
+
+    if( document.ptr == NULL )
+    {
+        lr_error_message("%s(): Error: Parameter %s does not exist!", function_name, source_param);
+        lr_abort();
+        y_arena_release(mark);
+        return 0;
+    }
+
+    p = document.ptr;
+    end = document.ptr + document.len;
+    active[0] = wanted;
+
+    while( wanted != 0 && (p = (const char*) memchr(p, '<', end - p)) != NULL )
+    {
+        const char* tag = p;
+
+        if( end - p >= 4 && strncmp(p, "<!--", 4) == 0 )
+        {
+            p = y_find(p + 4, end - p - 4, "-->", 3);
+            if( p == NULL ) { error = "unterminated comment"; break; }
+            p += 3;
+        }
+        else if( end - p >= 9 && strncmp(p, "<![CDATA[", 9) == 0 )
+        {
+            p = y_find(p + 9, end - p - 9, "]]>", 3);
+            if( p == NULL ) { error = "unterminated CDATA section"; break; }
+            p += 3;
+        }
+        else if( end - p >= 2 && (p[1] == '?' || p[1] == '!') )
+        {
+            // Processing instructions and DOCTYPE declarations.
+            p = (const char*) memchr(p, '>', end - p);
+            if( p == NULL ) { error = "unterminated declaration"; break; }
+            p++;
+        }
+        else if( end - p >= 2 && p[1] == '/' )
+        {
+            // End tag. Save the content of the elements that were being captured at this depth.
+            if( depth == 0 ) { error = "end tag without start tag"; break; }
+            for( i = 0; i < path_count; i++ )
+            {
+                y_xml_path* path = &paths[i];
+                if( path->content_start != NULL && path->depth == depth )
+                {
+                    y_xml_save_match(path, path->content_start, tag - path->content_start);
+                    path->content_start = NULL;
+                    if( path->single )
+                        wanted &= ~(1 << i);
+                }
+            }
+            depth--;
+            p = (const char*) memchr(p, '>', end - p);
+            if( p == NULL ) { error = "unterminated end tag"; break; }
+            p++;
+        }
+        else
+        {
+            // Start tag.
+            const char* name = p + 1;
+            const char* close;
+            const char* quote;
+            y_strview local;
+            unsigned int matched = 0;
+            int empty;
+
+            while( p < end && y_xml_is_name_char(*++p) )
+                ;
+            local = y_xml_local_name(name, p - name);
+
+            // Find the end of the tag, skipping over quoted attribute values.
+            close = p;
+            for(;;)
+            {
+                close = (const char*) memchr(close, '>', end - close);
+                if( close == NULL )
+                    break;
+                quote = p;
+                while( quote < close && *quote != '"' && *quote != '\'' )
+                    quote++;
+                if( quote == close )
+                    break;
+                // Skip the quoted value and look again from there.
+                p = (const char*) memchr(quote + 1, *quote, end - quote - 1);
+                if( p == NULL ) { close = NULL; break; }
+                close = ++p;
+            }
+            if( close == NULL ) { error = "unterminated start tag"; break; }
+            empty = close[-1] == '/';
+
+            if( depth < Y_XML_MAX_PATH_DEPTH && (active[depth] & wanted) != 0 )
+            {
+                for( i = 0; i < path_count; i++ )
+                {
+                    y_xml_path* path = &paths[i];
+                    y_strview step;
+                    if( !(active[depth] & wanted & (1 << i)) || path->depth <= depth )
+                        continue;
+                    step = path->steps[depth];
+                    if( !(step.len == 1 && step.ptr[0] == '*') && !y_strview_equals(y_xml_local_name(step.ptr, step.len), local) )
+                        continue;
+
+                    matched |= 1 << i;
+                    if( path->depth != depth + 1 )
+                        continue;
+                    if( path->attribute.ptr != NULL )
+                    {
+                        y_xml_save_attribute(path, local.ptr + local.len, close);
+                        if( path->single && path->count > 0 )
+                            wanted &= ~(1 << i);
+                    }
+                    else if( empty )
+                    {
+                        y_xml_save_match(path, "", 0);
+                        if( path->single )
+                            wanted &= ~(1 << i);
+                    }
+                    else
+                    {
+                        path->content_start = close + 1;
+                    }
+                }
+            }
+            p = close + 1;
+            if( !empty )
+            {
+                depth++;
+                if( depth <= Y_XML_MAX_PATH_DEPTH )
+                    active[depth] = matched;
+            }
+        }
+    }
+
+    if( error != NULL )
+    {
+        lr_error_message("%s(): Invalid XML in parameter %s at offset %d: %s", function_name, source_param, (p ? p : end) - document.ptr, error);
+        y_arena_release(mark);
+        return 0;
+    }
+
+    for( i = 0; i < path_count; i++ )
+    {
+        if( !paths[i].single )
+            y_array_save_count(paths[i].count, paths[i].result);
+    }
+    y_arena_release(mark);
+    return 1;
+}
+//! \endcond
+
+
+/*!
+\brief Save the content of all elements (or attributes) at an XML path into a parameter array.
+
+The document is tokenized once, without building a tree. See y_xml.c for the path syntax and how values are saved.
+
+\param [in] source_param The parameter containing the XML document.
+\param [in] path The path to the values, for example "/Envelope/Body/GetOrderResponse/Order/Id".
+\param [in] result_array The name of the parameter array to save the values in, using the same {name_N} and {name_count} conventions as y_array_save().
+\returns The number of values found, or -1 if the document is not valid XML. An invalid path logs an error and calls lr_abort().
+\sa y_xml_get_value(), y_xml_get_multi(), y_array_save_param_list()
+*/
+int y_xml_get(const char* source_param, const char* path, const char* result_array)
+{
+    y_xml_path* parsed = (y_xml_path*) y_mem_alloc(sizeof(y_xml_path));
+    int result = -1;
+
+    if( !y_xml_parse_path(path, parsed) )
+    {
+        free(parsed);
+        lr_abort();
+        return -1;
+    }
+    parsed->result = result_array;
+    if( y_xml_scan("y_xml_get", source_param, parsed, 1) )
+        result = parsed->count;
+    free(parsed);
+    return result;
+}
+
+/*!
+\brief Save the content of the first element (or attribute) at an XML path into a parameter.
+
+The scan stops as soon as the value has been found.
+
+\param [in] source_param The parameter containing the XML document.
+\param [in] path The path to the value, for example "/Envelope/Body/GetOrderResponse/Order/Id".
+\param [in] result_param The name of the parameter to save the value in. If there is no such value, it is not touched.
+\returns 1 if the value was found, 0 if it was not, or -1 if the document is not valid XML.
+\sa y_xml_get(), y_xml_get_multi()
+*/
+int y_xml_get_value(const char* source_param, const char* path, const char* result_param)
+{
+    y_xml_path* parsed = (y_xml_path*) y_mem_alloc(sizeof(y_xml_path));
+    int result = -1;
+
+    if( !y_xml_parse_path(path, parsed) )
+    {
+        free(parsed);
+        lr_abort();
+        return -1;
+    }
+    parsed->result = result_param;
+    parsed->single = 1;
+    if( y_xml_scan("y_xml_get_value", source_param, parsed, 1) )
+        result = parsed->count;
+    free(parsed);
+    return result;
+}
+
+/*!
+\brief Save the values at several XML paths into parameter arrays, in a single pass over the document.
+
+\param [in] source_param The parameter containing the XML document.
+\param [in] paths The paths. See y_xml.c for the syntax.
+\param [in] result_arrays For each path, the name of the parameter array to save the values in.
+\param [in] path_count The number of paths, at most Y_XML_MAX_PATHS.
+\returns The total number of values found, or -1 if the document is not valid XML. An invalid path logs an error and calls lr_abort().
+
+\b Example:
+\code
+char* paths[] = { "/Envelope/Body/GetOrderResponse/Order/Id", "/Envelope/Body/GetOrderResponse/Order/Status", "/Envelope/Header/Session/@id" };
+char* arrays[] = { "OrderId", "OrderStatus", "SessionId" };
+y_xml_get_multi("Response", paths, arrays, 3);
+\endcode
+\sa y_xml_get()
+*/
+int y_xml_get_multi(const char* source_param, char** paths, char** result_arrays, int path_count)
+{
+    y_xml_path* parsed;
+    int i, total = -1;
+
+    if( path_count < 0 || path_count > Y_XML_MAX_PATHS )
+    {
+        lr_error_message("y_xml_get_multi(): Cannot match %d paths in one pass, the maximum is %d.", path_count, Y_XML_MAX_PATHS);
+        lr_abort();
+        return -1;
+    }
+
+    parsed = (y_xml_path*) y_array_alloc(path_count + 1, sizeof(y_xml_path));
+    for( i = 0; i < path_count; i++ )
+    {
+        if( !y_xml_parse_path(paths[i], &parsed[i]) )
+        {
+            free(parsed);
+            lr_abort();
+            return -1;
+        }
+        parsed[i].result = result_arrays[i];
+    }
+
+    if( y_xml_scan("y_xml_get_multi", source_param, parsed, path_count) )
+    {
+        total = 0;
+        for( i = 0; i < path_count; i++ )
+            total += parsed[i].count;
+    }
+    free(parsed);
+    return total;
+}
+
+#endif // _Y_XML_C_